@@ -6,6 +6,7 @@
 #include <cstring>
 #include <expected> 
 #include <string_view>
+#include <cassert>
 
 namespace replicant {
 
@@ -21,6 +22,55 @@ namespace replicant {
         std::string message; 
     };
 
+    // Cursor over a range a Reader has already bounds-checked as a whole, for
+    // the inner loop over a table's records. Reads past the validated range are
+    // caught by asserts in debug builds only.
+    class UncheckedCursor {
+        const char* current_;
+        const char* end_;
+        const char* buffer_start_; // Whole reader buffer, relative offsets may point anywhere in it
+        const char* buffer_end_;
+
+    public:
+        UncheckedCursor(const char* begin, const char* end, const char* buffer_start, const char* buffer_end)
+            : current_(begin), end_(end), buffer_start_(buffer_start), buffer_end_(buffer_end) {
+        }
+
+        template <typename T>
+        const T* view() {
+            assert(sizeof(T) <= size_t(end_ - current_));
+            const T* ptr = reinterpret_cast<const T*>(current_);
+            current_ += sizeof(T);
+            return ptr;
+        }
+
+        template <typename T>
+        std::span<const T> viewArray(size_t count) {
+            assert(count * sizeof(T) <= size_t(end_ - current_));
+            const T* ptr = reinterpret_cast<const T*>(current_);
+            current_ += count * sizeof(T);
+            return std::span<const T>(ptr, count);
+        }
+
+        void skip(size_t bytes) {
+            assert(bytes <= size_t(end_ - current_));
+            current_ += bytes;
+        }
+
+        size_t remaining() const { return end_ - current_; }
+
+        // Empty for a zero offset or one pointing outside the buffer, never throws or allocates.
+        // The string ends at its terminator or at the end of the buffer
+        std::string_view stringRelative(const uint32_t& offsetField) const {
+            const char* target = reinterpret_cast<const char*>(&offsetField) + offsetField;
+            // One unsigned compare covers both ends
+            if (offsetField == 0 || size_t(target - buffer_start_) >= size_t(buffer_end_ - buffer_start_)) {
+                return std::string_view();
+            }
+            return std::string_view(target, strnlen(target, buffer_end_ - target));
+        }
+    };
+
     class Reader {
         const char* start_;
         const char* end_;
@@ -63,6 +113,25 @@ namespace replicant {
             return std::span<const T>(ptr, count);
         }
 
+        // Checks the extent of count records once, then hands out a cursor over
+        // them that doesn't check again. The reader moves past the records
+        template <typename T>
+        std::expected<UncheckedCursor, ReaderError> validateTable(size_t count) {
+            if (count > 0 && sizeof(T) > (size_t)(end_ - current_) / count) [[unlikely]] {
+                return std::unexpected(ReaderError{ ReaderErrorCode::OutOfBounds, "Buffer overrun validating table" });
+            }
+            return validateBytes(count * sizeof(T));
+        }
+
+        std::expected<UncheckedCursor, ReaderError> validateBytes(size_t bytes) {
+            if (bytes > (size_t)(end_ - current_)) [[unlikely]] {
+                return std::unexpected(ReaderError{ ReaderErrorCode::OutOfBounds, "Buffer overrun validating range" });
+            }
+            UncheckedCursor cursor(current_, current_ + bytes, start_, end_);
+            current_ += bytes;
+            return cursor;
+        }
+
         std::expected<const char*, ReaderError> getOffsetPtr(const uint32_t& offsetField) const {
             const char* fieldAddress = reinterpret_cast<const char*>(&offsetField);
 
@@ -91,5 +160,16 @@ namespace replicant {
 
             return std::string(ptr, len);
         }
+
+        // readStringRelative without the copy, the view points into the reader's buffer
+        std::expected<std::string_view, ReaderError> viewStringRelative(const uint32_t& offsetField) const {
+            if (offsetField == 0) return std::string_view();
+
+            auto ptrResult = getOffsetPtr(offsetField);
+            if (!ptrResult) return std::unexpected(ptrResult.error());
+
+            const char* ptr = *ptrResult;
+            return std::string_view(ptr, strnlen(ptr, end_ - ptr));
+        }
     };
 }
\ No newline at end of file
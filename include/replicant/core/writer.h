@@ -5,35 +5,112 @@
 #include <cstdint>
 #include <map>
 #include <span>
+#include <string_view>
+#include <memory_resource>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <functional>
 
 namespace replicant {
 
-    class Writer {
-        std::vector<std::byte> buffer_;
+    // Byte count a serializer is about to write, added up before writing so the
+    // buffer can be sized once. Alignment is planned relative to the plan's own
+    // start, reserveFor adds enough slack for wherever that start ends up.
+    class SizePlan {
+        size_t size_ = 0;
+        size_t max_alignment_ = 1;
 
     public:
-        Writer() = default;
+        template <typename T>
+        SizePlan& add(size_t count = 1) {
+            size_ += sizeof(T) * count;
+            return *this;
+        }
+
+        SizePlan& bytes(size_t size) {
+            size_ += size;
+            return *this;
+        }
+
+        // NUL terminated, as StringPool writes them
+        SizePlan& string(std::string_view str) {
+            size_ += str.size() + 1;
+            return *this;
+        }
+
+        SizePlan& align(size_t alignment) {
+            size_ = (size_ + alignment - 1) / alignment * alignment;
+            if (alignment > max_alignment_) max_alignment_ = alignment;
+            return *this;
+        }
+
+        size_t size() const { return size_; }
+        size_t maxAlignment() const { return max_alignment_; }
+    };
+
+    // Buffer is any contiguous container of std::byte, std::pmr::vector<std::byte>
+    // lets a serializer write into an arena it owns.
+    template <typename Buffer>
+    class BasicWriter {
+        static_assert(std::is_same_v<typename Buffer::value_type, std::byte>, "Writer buffers hold std::byte");
+
+        Buffer buffer_;
+
+        // Room for size more bytes, growing geometrically so streams of small writes stay amortized O(1)
+        std::byte* grow(size_t size) {
+            const size_t pos = buffer_.size();
+            if (buffer_.capacity() - pos < size) {
+                buffer_.reserve(std::max(buffer_.capacity() * 2, pos + size));
+            }
+            buffer_.resize(pos + size);
+            return buffer_.data() + pos;
+        }
+
+    public:
+        BasicWriter() = default;
 
-        explicit Writer(size_t reserved_size) { buffer_.reserve(reserved_size); }
+        explicit BasicWriter(size_t reserved_size) { buffer_.reserve(reserved_size); }
 
-        const std::vector<std::byte>& buffer() const { return buffer_; }
+        explicit BasicWriter(const typename Buffer::allocator_type& allocator, size_t reserved_size = 0)
+            : buffer_(allocator) {
+            buffer_.reserve(reserved_size);
+        }
+
+        const Buffer& buffer() const { return buffer_; }
         size_t tell() const { return buffer_.size(); }
 
+        // Hands the written bytes over without a copy, the writer is empty afterwards
+        Buffer release() { return std::exchange(buffer_, Buffer(buffer_.get_allocator())); }
+
+        void reserve(size_t total_size) { buffer_.reserve(total_size); }
+
+        void reserveFor(const SizePlan& plan) {
+            buffer_.reserve(tell() + plan.size() + plan.maxAlignment() - 1);
+        }
+
         template <typename T>
         void write(const T& value) {
-            const std::byte* ptr = reinterpret_cast<const std::byte*>(&value);
-            buffer_.insert(buffer_.end(), ptr, ptr + sizeof(T));
+            static_assert(std::is_trivially_copyable_v<T>, "Writer::write copies raw bytes");
+            std::memcpy(grow(sizeof(T)), &value, sizeof(T));
         }
 
         void write(const void* data, size_t size) {
-            const std::byte* ptr = reinterpret_cast<const std::byte*>(data);
-            buffer_.insert(buffer_.end(), ptr, ptr + size);
+            if (size == 0) return;
+            std::memcpy(grow(size), data, size);
+        }
+
+        // Whole array in one copy
+        template <typename T>
+        void writeArray(std::span<const T> values) {
+            static_assert(std::is_trivially_copyable_v<T>, "Writer::writeArray copies raw bytes");
+            write(values.data(), values.size_bytes());
         }
 
         void align(size_t alignment) {
             size_t current = tell();
             size_t padding = (alignment - (current % alignment)) % alignment;
-            for (size_t i = 0; i < padding; i++) buffer_.push_back(std::byte{ 0 });
+            if (padding) grow(padding); // resize zero fills
         }
 
         size_t reserveOffset() {
@@ -59,7 +136,12 @@ namespace replicant {
         }
     };
 
+    using Writer = BasicWriter<std::vector<std::byte>>;
+    using PmrWriter = BasicWriter<std::pmr::vector<std::byte>>;
+
 
+    // Layout shared with the prebuilt libreplicant, which still uses this one.
+    // Leave it as is until the library moves over to InternedStringPool
     class StringPool {
         std::map<std::string, std::vector<size_t>> pending_patches_;
 
@@ -83,4 +165,142 @@ namespace replicant {
             pending_patches_.clear();
         }
     };
+
+    // Strings referenced by relative offsets, written together after the data
+    // that points at them. Each distinct string is stored once in an arena and
+    // found through an open addressing table keyed on its contents. Output is in
+    // lexicographic order whatever order the strings were added in, the same bytes
+    // StringPool writes.
+    //
+    // With tail merging a string that is the end of another one, "Sword" inside
+    // "LongSword", is not written at all and its offsets point into the longer one.
+    class InternedStringPool {
+        struct Entry {
+            size_t offset; // Into arena_
+            size_t length;
+            size_t hash;
+        };
+
+        struct Patch {
+            size_t patch_loc;
+            uint32_t entry;
+        };
+
+        static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+        std::string arena_;
+        std::vector<Entry> entries_;
+        std::vector<uint32_t> slots_; // Entry index or EMPTY_SLOT, size is a power of two
+        std::vector<Patch> patches_;
+        bool merge_tails_ = false;
+
+        std::string_view view(const Entry& entry) const {
+            return std::string_view(arena_.data() + entry.offset, entry.length);
+        }
+
+        void rehash(size_t slot_count) {
+            slots_.assign(slot_count, EMPTY_SLOT);
+            for (uint32_t i = 0; i < entries_.size(); ++i) {
+                size_t slot = entries_[i].hash & (slot_count - 1);
+                while (slots_[slot] != EMPTY_SLOT) slot = (slot + 1) & (slot_count - 1);
+                slots_[slot] = i;
+            }
+        }
+
+        uint32_t intern(std::string_view str) {
+            // Kept at most half full so probe runs stay short
+            if ((entries_.size() + 1) * 2 > slots_.size()) {
+                rehash(std::max<size_t>(slots_.size() * 2, 64));
+            }
+
+            const size_t hash = std::hash<std::string_view>{}(str);
+            size_t slot = hash & (slots_.size() - 1);
+            while (slots_[slot] != EMPTY_SLOT) {
+                const Entry& entry = entries_[slots_[slot]];
+                if (entry.hash == hash && view(entry) == str) return slots_[slot];
+                slot = (slot + 1) & (slots_.size() - 1);
+            }
+
+            const uint32_t index = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(Entry{ arena_.size(), str.size(), hash });
+            arena_.append(str);
+            slots_[slot] = index;
+            return index;
+        }
+
+    public:
+        InternedStringPool() = default;
+
+        explicit InternedStringPool(bool merge_tails) : merge_tails_(merge_tails) {}
+
+        void setMergeTails(bool merge_tails) { merge_tails_ = merge_tails; }
+
+        void add(std::string_view str, size_t patch_loc) {
+            if (str.empty()) return;
+            patches_.push_back(Patch{ patch_loc, intern(str) });
+        }
+
+        size_t size() const { return entries_.size(); }
+
+        void clear() {
+            arena_.clear();
+            entries_.clear();
+            slots_.clear();
+            patches_.clear();
+        }
+
+        template <typename Buffer>
+        void flush(BasicWriter<Buffer>& writer) {
+            std::vector<uint32_t> order(entries_.size());
+            for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+            // host[i] is the entry whose bytes entry i is written as part of, itself unless merged
+            std::vector<uint32_t> host(order);
+            if (merge_tails_) {
+                // Sorted by reversed contents a string's extensions follow it directly,
+                // so one pass from the back finds the longest string each one ends
+                std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+                    const std::string_view va = view(entries_[a]), vb = view(entries_[b]);
+                    return std::lexicographical_compare(va.rbegin(), va.rend(), vb.rbegin(), vb.rend());
+                });
+                for (size_t i = order.size(); i-- > 1;) {
+                    const std::string_view tail = view(entries_[order[i - 1]]);
+                    const std::string_view next = view(entries_[order[i]]);
+                    if (next.size() > tail.size() && next.ends_with(tail)) {
+                        host[order[i - 1]] = host[order[i]];
+                    }
+                }
+            }
+
+            std::vector<uint32_t> written;
+            written.reserve(entries_.size());
+            size_t total_size = 0;
+            for (uint32_t i = 0; i < entries_.size(); ++i) {
+                if (host[i] != i) continue;
+                written.push_back(i);
+                total_size += entries_[i].length + 1;
+            }
+            std::sort(written.begin(), written.end(), [this](uint32_t a, uint32_t b) {
+                return view(entries_[a]) < view(entries_[b]);
+            });
+            writer.reserve(writer.tell() + total_size);
+
+            std::vector<size_t> positions(entries_.size());
+            for (uint32_t index : written) {
+                positions[index] = writer.tell();
+                writer.write(arena_.data() + entries_[index].offset, entries_[index].length);
+                writer.template write<char>('\0');
+            }
+            for (uint32_t i = 0; i < entries_.size(); ++i) {
+                if (host[i] != i) {
+                    positions[i] = positions[host[i]] + entries_[host[i]].length - entries_[i].length;
+                }
+            }
+
+            for (const Patch& patch : patches_) {
+                writer.satisfyOffset(patch.patch_loc, positions[patch.entry]);
+            }
+            clear();
+        }
+    };
 }
\ No newline at end of file
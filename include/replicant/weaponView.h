@@ -0,0 +1,152 @@
+#pragma once
+#include "replicant/weapon.h"
+#include "replicant/core/reader.h"
+#include "replicant/core/writer.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+
+namespace replicant::weapon {
+
+    enum class WeaponName {
+        InternalHeader, // RawWeaponEntry::offsetInternalNameHead
+        Japanese,       // RawWeaponBody::offestToJPName
+        InternalBody,   // RawWeaponBody::offsetToInternalWeaponName
+        Count
+    };
+
+    // Weapon spec file used in place. The records stay in the caller's buffer
+    // and are edited through references to them, names are views into the same
+    // buffer. Only renames are kept on the side, and only when there are any does
+    // serialising write a new string table; otherwise it is a copy of the buffer.
+    //
+    // Like every other offset in the format, offsetToDataStart is relative to
+    // its own field. The buffer must outlive the view and not be reallocated.
+    class WeaponSpecsView {
+        std::span<std::byte> data_;
+        raw::RawWeaponEntry* entries_ = nullptr;
+        size_t count_ = 0;
+        // One per name of each record once anything is renamed, empty before
+        std::vector<std::optional<std::string>> renamed_;
+
+        WeaponSpecsView(std::span<std::byte> data, raw::RawWeaponEntry* entries, size_t count)
+            : data_(data), entries_(entries), count_(count) {
+        }
+
+        static constexpr size_t NAMES = static_cast<size_t>(WeaponName::Count);
+
+        static const uint32_t& nameField(const raw::RawWeaponEntry& entry, WeaponName name) {
+            switch (name) {
+            case WeaponName::InternalHeader: return entry.offsetInternalNameHead;
+            case WeaponName::Japanese: return entry.body.offestToJPName;
+            default: return entry.body.offsetToInternalWeaponName;
+            }
+        }
+
+        UncheckedCursor stringCursor() const {
+            const char* begin = reinterpret_cast<const char*>(data_.data());
+            return UncheckedCursor(begin, begin, begin, begin + data_.size());
+        }
+
+        const std::string* renamed(size_t index, WeaponName name) const {
+            if (renamed_.empty()) return nullptr;
+            const auto& value = renamed_[index * NAMES + static_cast<size_t>(name)];
+            return value ? &*value : nullptr;
+        }
+
+    public:
+        static std::expected<WeaponSpecsView, WeaponError> open(std::span<std::byte> data) {
+            Reader reader{ std::span<const std::byte>(data) };
+            auto header = reader.view<raw::RawHeader>();
+            if (!header) return std::unexpected(WeaponError{ WeaponErrorCode::ParseError, header.error().message });
+
+            auto dataStart = reader.getOffsetPtr((*header)->offsetToDataStart);
+            if (!dataStart) return std::unexpected(WeaponError{ WeaponErrorCode::ParseError, dataStart.error().message });
+
+            const size_t start = *dataStart - reinterpret_cast<const char*>(data.data());
+            Reader records{ std::span<const std::byte>(data.subspan(start)) };
+            auto table = records.validateTable<raw::RawWeaponEntry>((*header)->entryCount);
+            if (!table) return std::unexpected(WeaponError{ WeaponErrorCode::ParseError, table.error().message });
+
+            return WeaponSpecsView(data, reinterpret_cast<raw::RawWeaponEntry*>(data.data() + start), (*header)->entryCount);
+        }
+
+        size_t size() const { return count_; }
+
+        // For passes over every record, no copies and no allocations
+        std::span<raw::RawWeaponEntry> entries() { return std::span<raw::RawWeaponEntry>(entries_, count_); }
+        std::span<const raw::RawWeaponEntry> entries() const { return std::span<const raw::RawWeaponEntry>(entries_, count_); }
+
+        raw::RawWeaponBody& body(size_t index) { return entries_[index].body; }
+        const raw::RawWeaponBody& body(size_t index) const { return entries_[index].body; }
+
+        // Renamed value if there is one, otherwise a view into the buffer. Empty
+        // for a zero offset or one pointing outside the buffer
+        std::string_view name(size_t index, WeaponName name) const {
+            if (const std::string* value = renamed(index, name)) return *value;
+            return stringCursor().stringRelative(nameField(entries_[index], name));
+        }
+
+        // Setting a name to what it already is doesn't count as a change
+        void setName(size_t index, WeaponName name, std::string_view value) {
+            const bool original = stringCursor().stringRelative(nameField(entries_[index], name)) == value;
+            if (renamed_.empty()) {
+                if (original) return;
+                renamed_.resize(count_ * NAMES);
+            }
+            auto& slot = renamed_[index * NAMES + static_cast<size_t>(name)];
+            if (original) slot.reset();
+            else slot = std::string(value);
+        }
+
+        bool namesChanged() const {
+            for (const auto& value : renamed_) {
+                if (value) return true;
+            }
+            return false;
+        }
+
+        // The file with the records as they are now. Without renames that is the
+        // buffer unchanged; with them everything up to the end of the records is
+        // kept and a new string table holding every name is written after it
+        std::vector<std::byte> serialise() const {
+            if (!namesChanged()) return std::vector<std::byte>(data_.begin(), data_.end());
+
+            const size_t recordsStart = reinterpret_cast<const std::byte*>(entries_) - data_.data();
+            const size_t recordsEnd = recordsStart + count_ * sizeof(raw::RawWeaponEntry);
+
+            SizePlan plan;
+            plan.bytes(recordsEnd);
+            InternedStringPool strings;
+            for (size_t i = 0; i < count_; ++i) {
+                for (size_t n = 0; n < NAMES; ++n) {
+                    plan.string(name(i, static_cast<WeaponName>(n)));
+                }
+            }
+
+            Writer writer;
+            writer.reserveFor(plan);
+            writer.write(data_.data(), recordsEnd);
+
+            for (size_t i = 0; i < count_; ++i) {
+                const char* record = reinterpret_cast<const char*>(&entries_[i]);
+                for (size_t n = 0; n < NAMES; ++n) {
+                    const WeaponName which = static_cast<WeaponName>(n);
+                    const size_t patchLoc = recordsStart + i * sizeof(raw::RawWeaponEntry) +
+                        (reinterpret_cast<const char*>(&nameField(entries_[i], which)) - record);
+                    const std::string_view value = name(i, which);
+                    // Empty names are a zero offset, which the pool leaves alone
+                    if (value.empty()) writer.satisfyOffset(patchLoc, patchLoc);
+                    strings.add(value, patchLoc);
+                }
+            }
+            strings.flush(writer);
+            return writer.release();
+        }
+    };
+}
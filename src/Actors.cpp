@@ -0,0 +1,131 @@
+#include "Actors.h"
+#include "Offsets.h"
+#include <LunarTear++.h>
+#include <cstring>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace {
+    constexpr uintptr_t RTTI_NAME_OFFSET = 0x10;
+
+    // cparams sits far into the actor (past 0x14000) and not every type in the
+    // secondary list is that large or owns a CParamSet, so both the pointer and
+    // the set are read like user supplied watch addresses: a bad one fails the read
+    // instead of faulting on the game thread
+    template <typename T>
+    bool readGuarded(const void* address, T& out) {
+#ifdef _WIN32
+        SIZE_T read = 0;
+        return ReadProcessMemory(GetCurrentProcess(), address, &out, sizeof(T), &read) && read == sizeof(T);
+#else
+        std::memcpy(&out, address, sizeof(T));
+        return true;
+#endif
+    }
+}
+
+QString getActorRttiName(void* vtable) {
+    if (!vtable) return "N/A";
+    try {
+        uintptr_t rtti_col_ptr = *reinterpret_cast<uintptr_t*>(reinterpret_cast<uintptr_t>(vtable) - 8);
+        if (!rtti_col_ptr) return "N/A";
+
+        uintptr_t baseAddr = LunarTear::Get().Game().GetProcessBaseAddress();
+        uint32_t hierarchy_desc_rva = *reinterpret_cast<uint32_t*>(rtti_col_ptr + 0x10);
+        uintptr_t hierarchy_desc_addr = baseAddr + hierarchy_desc_rva;
+        uint32_t num_base_classes = *reinterpret_cast<uint32_t*>(hierarchy_desc_addr + 0x08);
+        if (num_base_classes == 0) return "N/A";
+
+        uint32_t base_class_array_rva = *reinterpret_cast<uint32_t*>(hierarchy_desc_addr + 0x0C);
+        uintptr_t base_class_array_addr = baseAddr + base_class_array_rva;
+        uint32_t desc_rva = *reinterpret_cast<uint32_t*>(base_class_array_addr);
+        uintptr_t type_desc_rva_ptr = baseAddr + desc_rva;
+        uint32_t type_desc_rva = *reinterpret_cast<uint32_t*>(type_desc_rva_ptr);
+        uintptr_t type_desc_addr = baseAddr + type_desc_rva;
+
+        char name_buffer[256];
+        memcpy(name_buffer, reinterpret_cast<void*>(type_desc_addr + RTTI_NAME_OFFSET), 255);
+        name_buffer[255] = '\0';
+
+        return QString(name_buffer).split("@@")[0].remove(".?AV");
+
+    }
+    catch (...) {
+        return "Parse Error";
+    }
+}
+
+std::vector<EntityInfo> captureActorSnapshot()
+{
+    std::vector<EntityInfo> entities;
+
+    auto* pManager = reinterpret_cast<ActorListControllerPair*>(Offsets::address(GameOffset::ActorManager));
+    ActorListController* list = &pManager->secondary_list;
+
+    // The player's position is read from the playable actor, where the rest of the console reads it
+    ActorPlayable* player = LunarTear::Get().Game().GetActorPlayable();
+
+    cActor* currentActor = list->head;
+    if (currentActor) {
+        if (list->count > 0) entities.reserve(static_cast<size_t>(list->count));
+        do {
+            EntityInfo info;
+            info.pActor = reinterpret_cast<uintptr_t>(currentActor);
+            info.actorId = currentActor->actor_id;
+            info.rtti = getActorRttiName(currentActor->vtable);
+
+            info.hp = -1;
+            info.x = info.y = info.z = 0.0f;
+            info.hasPosition = false;
+            CParamSet* paramsAddress = nullptr;
+            CParamSet params;
+            if (readGuarded(&currentActor->cparams, paramsAddress) && paramsAddress &&
+                readGuarded(paramsAddress, params) && params.vtable) {
+                info.hp = params.health;
+                info.x = params.x_pos;
+                info.y = params.y_pos;
+                info.z = params.z_pos;
+                info.hasPosition = std::isfinite(info.x) && std::isfinite(info.y) && std::isfinite(info.z);
+            }
+            if (player && reinterpret_cast<void*>(currentActor) == player) {
+                info.x = player->posX;
+                info.y = player->posY;
+                info.z = player->posZ;
+                info.hasPosition = true;
+            }
+            entities.push_back(info);
+
+            currentActor = currentActor->next_actor_secondary;
+        } while (currentActor && currentActor != list->head);
+    }
+
+    return entities;
+}
+
+std::vector<int> positionedActors(const std::vector<EntityInfo>& entities, std::vector<QVector3D>& positions)
+{
+    std::vector<int> indices;
+    indices.reserve(entities.size());
+    positions.clear();
+    positions.reserve(entities.size());
+    for (int i = 0; i < static_cast<int>(entities.size()); ++i) {
+        if (!entities[i].hasPosition) continue;
+        indices.push_back(i);
+        positions.push_back(entities[i].position());
+    }
+    return indices;
+}
+
+bool isPlayerActor(const EntityInfo& info)
+{
+    return info.pActor == reinterpret_cast<uintptr_t>(LunarTear::Get().Game().GetActorPlayable());
+}
+
+bool isEnemyActor(const EntityInfo& info)
+{
+    return !isPlayerActor(info) && info.rtti.contains("Enemy", Qt::CaseInsensitive);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <QString>
+#include <QVector3D>
+#include <vector>
+#include <cstdint>
+
+
+#pragma pack(push, 1)
+struct CParamSet {
+    void** vtable;
+    char padding1[3 * 8];
+    int cparamsetforvehcile_id;
+    char padding2[89 * 8];
+    int health;
+    char padding3[6 * 8];
+    float x_pos;
+    float y_pos;
+    float z_pos;
+};
+
+struct cActor {
+    void* vtable;
+    cActor* prev_actor_primary;
+    cActor* next_actor_primary;
+    cActor* prev_actor_secondary;
+    cActor* next_actor_secondary;
+    char padding1[0x1B0];
+    int actor_id;
+    char padding2[0x14174];
+    CParamSet* cparams;
+};
+
+struct ActorListController {
+    cActor* head;
+    cActor* tail;
+    int64_t count;
+};
+
+struct ActorListControllerPair {
+    ActorListController primary_list;
+    ActorListController secondary_list;
+};
+#pragma pack(pop)
+
+
+struct EntityInfo {
+    uintptr_t pActor;
+    int actorId;
+    QString name;
+    QString rtti;
+    int hp;
+    float x, y, z;
+    bool hasPosition; // False when the actor has no parameter set to read x, y and z from
+
+    QVector3D position() const { return QVector3D(x, y, z); }
+};
+
+// Walks the game's actor list. Must only be called while the game is active
+std::vector<EntityInfo> captureActorSnapshot();
+
+// Positions of the entities that have one, for a SpatialIndex. Returns the
+// entity index of each position, in the same order
+std::vector<int> positionedActors(const std::vector<EntityInfo>& entities, std::vector<QVector3D>& positions);
+
+QString getActorRttiName(void* vtable);
+
+bool isPlayerActor(const EntityInfo& info);
+bool isEnemyActor(const EntityInfo& info);
@@ -4,10 +4,16 @@
 #include <GameData.h>
 #include <mutex>
 #include "Callbacks.h"
+#include "Actors.h"
+#include "util/SpatialIndex.h"
+#include "Watches.h"
 
 static std::string g_currentCommand;
 static std::string g_currentResult;
 static std::mutex g_commandMutex;
+static std::string g_actorQueryResult;
+static std::string g_watchQueryResult;
+static uint64_t g_watchEventSequence = 0;
 
 namespace {
 	void _GetCommand(ScriptState* state) {
@@ -42,6 +48,112 @@ namespace {
 
 
 
+	void _GetNearestActor(ScriptState* state) {
+
+		int actorId = -1;
+		if (GameData::instance().isGameActive()) {
+			std::vector<EntityInfo> actors = captureActorSnapshot();
+			std::vector<QVector3D> positions;
+			std::vector<int> indexed = positionedActors(actors, positions);
+
+			SpatialIndex index;
+			index.build(positions);
+
+			// The player can be in the actor list itself, so look one further
+			for (int i : index.nearest(GameData::instance().getPlayerPosition(), 2)) {
+				if (!isPlayerActor(actors[indexed[i]])) {
+					actorId = actors[indexed[i]].actorId;
+					break;
+				}
+			}
+		}
+
+		LunarTear::Get().Game().SetArgumentInt(state->returnBuffer, actorId);
+		state->returnArgCount = 1;
+	}
+
+	void _GetActorsInRadius(ScriptState* state) {
+
+		void* pArg = LunarTear::Get().Game().GetArgumentPointer(state->argBuffer, 0);
+		float radius = LunarTear::Get().Game().GetArgumentFloat(pArg);
+
+		g_actorQueryResult.clear();
+		if (GameData::instance().isGameActive()) {
+			std::vector<EntityInfo> actors = captureActorSnapshot();
+			std::vector<QVector3D> positions;
+			std::vector<int> indexed = positionedActors(actors, positions);
+
+			SpatialIndex index;
+			index.build(positions);
+
+			for (int i : index.withinRadius(GameData::instance().getPlayerPosition(), radius)) {
+				const EntityInfo& actor = actors[indexed[i]];
+				if (isPlayerActor(actor)) continue;
+				if (!g_actorQueryResult.empty()) g_actorQueryResult += ',';
+				g_actorQueryResult += std::to_string(actor.actorId);
+			}
+		}
+
+		LunarTear::Get().Game().SetArgumentString(state->returnBuffer, g_actorQueryResult.c_str());
+		state->returnArgCount = 1;
+	}
+
+
+	void _WatchAdd(ScriptState* state) {
+
+		void* pArg = LunarTear::Get().Game().GetArgumentPointer(state->argBuffer, 0);
+		const char* arg = LunarTear::Get().Game().GetArgumentString(pArg);
+
+		int watchId = -1;
+		if (arg) {
+			if (auto definition = parseWatchSpec(QString::fromUtf8(arg))) {
+				watchId = static_cast<int>(WatchManager::instance().addWatch(*definition));
+			}
+		}
+
+		LunarTear::Get().Game().SetArgumentInt(state->returnBuffer, watchId);
+		state->returnArgCount = 1;
+	}
+
+	void _WatchRemove(ScriptState* state) {
+
+		void* pArg = LunarTear::Get().Game().GetArgumentPointer(state->argBuffer, 0);
+		int watchId = LunarTear::Get().Game().GetArgumentInt(pArg);
+
+		WatchManager::instance().removeWatch(static_cast<WatchId>(watchId));
+	}
+
+	void _WatchStats(ScriptState* state) {
+
+		void* pArg = LunarTear::Get().Game().GetArgumentPointer(state->argBuffer, 0);
+		int watchId = LunarTear::Get().Game().GetArgumentInt(pArg);
+
+		g_watchQueryResult.clear();
+		if (auto stats = WatchManager::instance().stats(static_cast<WatchId>(watchId))) {
+			g_watchQueryResult = QString("last=%1;min=%2;max=%3;changes=%4;changes_per_sec=%5;value_per_sec=%6")
+				.arg(stats->last).arg(stats->min).arg(stats->max).arg(stats->changeCount)
+				.arg(stats->changesPerSecond).arg(stats->valuePerSecond).toStdString();
+		}
+
+		LunarTear::Get().Game().SetArgumentString(state->returnBuffer, g_watchQueryResult.c_str());
+		state->returnArgCount = 1;
+	}
+
+	// Changes since the previous call as "id:frame:old:new" entries separated by commas
+	void _WatchEvents(ScriptState* state) {
+
+		g_watchQueryResult.clear();
+		for (const auto& event : WatchManager::instance().eventsSince(g_watchEventSequence)) {
+			if (!g_watchQueryResult.empty()) g_watchQueryResult += ',';
+			g_watchQueryResult += QString("%1:%2:%3:%4").arg(event.id).arg(event.frame).arg(event.oldValue).arg(event.newValue).toStdString();
+			g_watchEventSequence = event.sequence;
+		}
+
+		LunarTear::Get().Game().SetArgumentString(state->returnBuffer, g_watchQueryResult.c_str());
+		state->returnArgCount = 1;
+	}
+
+
 	void _PostStartMessage(ScriptState* state) {
 		while (true) {
 			std::function<void()> task;
@@ -104,4 +216,22 @@ void Binding_PostStartMessage(void* L) {
 }
 void Binding_PostLoadMessage(void* L) {
 	LunarTear::Get().Game().PhaseBindingDispatcher(L, _PostLoadMessage);
+}
+void Binding_GetNearestActor(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _GetNearestActor);
+}
+void Binding_GetActorsInRadius(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _GetActorsInRadius);
+}
+void Binding_WatchAdd(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _WatchAdd);
+}
+void Binding_WatchRemove(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _WatchRemove);
+}
+void Binding_WatchStats(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _WatchStats);
+}
+void Binding_WatchEvents(void* L) {
+	LunarTear::Get().Game().PhaseBindingDispatcher(L, _WatchEvents);
 }
\ No newline at end of file
@@ -1,4 +1,10 @@
 void Binding_SetCommandResult(void* L);
 void Binding_GetCommand(void* L);
 void Binding_PostStartMessage(void* L);
-void Binding_PostLoadMessage(void* L);
\ No newline at end of file
+void Binding_PostLoadMessage(void* L);
+void Binding_GetNearestActor(void* L);
+void Binding_GetActorsInRadius(void* L);
+void Binding_WatchAdd(void* L);
+void Binding_WatchRemove(void* L);
+void Binding_WatchStats(void* L);
+void Binding_WatchEvents(void* L);
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "Callbacks.h"
+#include <LunarTear++.h>
+#include <chrono>
+#include <algorithm>
 
 
 std::queue<std::function<void()>> postLoadTaskQueue;
@@ -49,4 +52,56 @@ CallbackId registerPostStartCallback(std::function<void()> callback) {
 void unregisterPostStartCallback(CallbackId id) {
     std::lock_guard<std::mutex> lock(postStartCallbacksMutex);
     postStartCallbacks.erase(id);
+}
+
+std::map<CallbackId, FrameCallback> frameCallbacks;
+std::mutex frameCallbacksMutex;
+std::atomic<CallbackId> nextFrameCallbackId = 1;
+
+namespace {
+    // Clamp so the first update after a loading screen doesn't produce a huge step
+    constexpr float MAX_FRAME_DELTA = 0.1f;
+
+    std::chrono::steady_clock::time_point lastFrameTime;
+
+    void runFrameCallbacks() {
+        auto now = std::chrono::steady_clock::now();
+        float deltaSeconds = std::chrono::duration<float>(now - lastFrameTime).count();
+        deltaSeconds = std::clamp(deltaSeconds, 0.0f, MAX_FRAME_DELTA);
+        lastFrameTime = now;
+
+        std::vector<FrameCallback> callbacksToRun;
+        {
+            std::lock_guard<std::mutex> lock(frameCallbacksMutex);
+            for (const auto& pair : frameCallbacks) {
+                callbacksToRun.push_back(pair.second);
+            }
+        }
+        for (const auto& func : callbacksToRun) {
+            func(deltaSeconds);
+        }
+
+        // Update tasks are one-shot, so re-arm for the next frame
+        LunarTear::Get().QueuePhaseUpdateCallback(runFrameCallbacks);
+    }
+}
+
+CallbackId registerFrameCallback(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(frameCallbacksMutex);
+    CallbackId id = nextFrameCallbackId.fetch_add(1);
+    frameCallbacks[id] = std::move(callback);
+    return id;
+}
+
+void unregisterFrameCallback(CallbackId id) {
+    std::lock_guard<std::mutex> lock(frameCallbacksMutex);
+    frameCallbacks.erase(id);
+}
+
+void startFrameCallbackPump() {
+    static std::once_flag started;
+    std::call_once(started, [] {
+        lastFrameTime = std::chrono::steady_clock::now();
+        LunarTear::Get().QueuePhaseUpdateCallback(runFrameCallbacks);
+    });
 }
\ No newline at end of file
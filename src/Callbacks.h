@@ -27,4 +27,15 @@ CallbackId registerPostLoadCallback(std::function<void()> callback);
 void unregisterPostLoadCallback(CallbackId id);
 
 CallbackId registerPostStartCallback(std::function<void()> callback);
-void unregisterPostStartCallback(CallbackId id);
\ No newline at end of file
+void unregisterPostStartCallback(CallbackId id);
+
+// Frame callbacks run on the game thread once per phase update with the elapsed time in seconds
+using FrameCallback = std::function<void(float deltaSeconds)>;
+
+extern std::map<CallbackId, FrameCallback> frameCallbacks;
+extern std::mutex frameCallbacksMutex;
+
+CallbackId registerFrameCallback(FrameCallback callback);
+void unregisterFrameCallback(CallbackId id);
+
+void startFrameCallbackPump();
\ No newline at end of file
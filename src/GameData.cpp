@@ -2,6 +2,8 @@
 #include <LunarTear++.h>
 #include <mutex>
 #include "Callbacks.h"
+#include "Offsets.h"
+#include "Inventory.h"
 #include <cmath>
 
 
@@ -14,7 +16,7 @@ struct CameraMatrix {
 namespace {
 
     const CameraMatrix* getCameraMatrix() {
-        uintptr_t camManagerAddr = LunarTear::Get().Game().GetProcessBaseAddress() + 0x32e7a00;
+        uintptr_t camManagerAddr = Offsets::address(GameOffset::CameraManager);
         if (!camManagerAddr) return nullptr;
         return (const CameraMatrix*)(camManagerAddr + 0x240);
     }
@@ -39,7 +41,7 @@ bool GameData::isGameActive()
 }
 
 std::span<replicant::raw::RawWeaponBody*> GameData::getWeaponSpecs() {
-	auto weaponSpecBase = reinterpret_cast<replicant::raw::RawWeaponBody**>(LunarTear::Get().Game().GetProcessBaseAddress() + 0x47c2670);
+	auto weaponSpecBase = reinterpret_cast<replicant::raw::RawWeaponBody**>(Offsets::address(GameOffset::WeaponSpecs));
 
     return std::span<replicant::raw::RawWeaponBody*>(
         weaponSpecBase,
@@ -137,6 +139,15 @@ float GameData::getCameraPitch()
 }
 
 
+QVector3D GameData::getCameraForward()
+{
+    const CameraMatrix* matrix = getCameraMatrix();
+    if (!matrix) return QVector3D();
+
+    const float* matrixData = &(matrix->m[0][0]);
+    return QVector3D(matrixData[8], matrixData[9], matrixData[10]).normalized();
+}
+
 void GameData::setInvincible(bool enabled)
 {
     QString command = QString("_SetUniqueActorInvincible(-1, %1)").arg(enabled ? 500000 : 0);
@@ -197,14 +208,7 @@ void GameData::setMaxMoney()
 
 void GameData::setMaxItems()
 {
-    LunarTear::Get().QueuePhaseScriptExecution(R"(
-
-    for itemId = 0, 767 do
-        _AddItemNum(itemId, 99999) 
-    end                                                                                                                                  
-
-)");
-
+    Inventory::fillItems(MAX_ITEM_COUNT);
 }
 
 void GameData::setPlayerLevel(int level)
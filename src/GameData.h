@@ -18,6 +18,7 @@ public:
 
     float getCameraYaw();
     float getCameraPitch();
+    QVector3D getCameraForward();
 
     std::span<replicant::raw::RawWeaponBody*> getWeaponSpecs();
 
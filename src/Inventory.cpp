@@ -0,0 +1,110 @@
+#include "Inventory.h"
+#include "common/GameStrings.h"
+#include <LunarTear++.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr char LOADOUT_MAGIC[4] = { 'L', 'T', 'I', 'V' };
+    constexpr uint16_t LOADOUT_VERSION = 1;
+    constexpr int LOADOUT_HEADER_SIZE = 8;
+
+    static_assert(sizeof(PlayerSaveData::Inventory) == INVENTORY_SLOT_COUNT);
+
+    // Game thread only
+    void applyNow(const std::vector<InventoryChange>& changes) {
+        if (!LunarTear::Get().Game().GetPlayerSaveData()) return;
+        for (const auto& change : changes) {
+            if (change.itemId < 0 || change.itemId >= INVENTORY_SLOT_COUNT) continue;
+            LunarTear::Get().Game().SetPlayerItemCount(change.itemId, static_cast<char>(change.count));
+        }
+    }
+}
+
+void Inventory::fillItems(uint8_t count)
+{
+    count = std::min(count, MAX_ITEM_COUNT);
+
+    LunarTear::Get().QueuePhaseUpdateCallback([count]() {
+        PlayerSaveData* save = LunarTear::Get().Game().GetPlayerSaveData();
+        if (!save) return;
+        std::vector<InventoryChange> changes;
+        for (int i = 0; i < INVENTORY_SLOT_COUNT; ++i) {
+            if (static_cast<uint8_t>(save->Inventory[i]) >= count) continue;
+            if (GetItemName(i).isNull()) continue;
+            changes.push_back({ i, count });
+        }
+        applyNow(changes);
+    });
+}
+
+void Inventory::applyChanges(std::vector<InventoryChange> changes)
+{
+    if (changes.empty()) return;
+
+    LunarTear::Get().QueuePhaseUpdateCallback([changes = std::move(changes)]() {
+        applyNow(changes);
+    });
+}
+
+void Inventory::restore(const InventorySnapshot& snapshot)
+{
+    // Diffed on the game thread, against the inventory as it is when the writes happen
+    LunarTear::Get().QueuePhaseUpdateCallback([snapshot]() {
+        PlayerSaveData* save = LunarTear::Get().Game().GetPlayerSaveData();
+        if (!save) return;
+        std::vector<InventoryChange> changes;
+        for (int i = 0; i < INVENTORY_SLOT_COUNT; ++i) {
+            if (static_cast<uint8_t>(save->Inventory[i]) != snapshot[i]) {
+                changes.push_back({ i, snapshot[i] });
+            }
+        }
+        applyNow(changes);
+    });
+}
+
+void Inventory::capture(CaptureCallback callback)
+{
+    LunarTear::Get().QueuePhaseUpdateCallback([callback = std::move(callback)]() {
+        PlayerSaveData* save = LunarTear::Get().Game().GetPlayerSaveData();
+        if (!save) {
+            callback(std::nullopt);
+            return;
+        }
+
+        InventorySnapshot snapshot;
+        std::memcpy(snapshot.data(), save->Inventory, snapshot.size());
+        callback(snapshot);
+    });
+}
+
+QByteArray Inventory::exportLoadout(const InventorySnapshot& snapshot)
+{
+    QByteArray blob;
+    blob.reserve(LOADOUT_HEADER_SIZE + INVENTORY_SLOT_COUNT);
+    blob.append(LOADOUT_MAGIC, sizeof(LOADOUT_MAGIC));
+
+    uint16_t header[2] = { LOADOUT_VERSION, static_cast<uint16_t>(INVENTORY_SLOT_COUNT) };
+    blob.append(reinterpret_cast<const char*>(header), sizeof(header));
+    blob.append(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+    return blob;
+}
+
+bool Inventory::importLoadout(const QByteArray& blob)
+{
+    if (blob.size() < LOADOUT_HEADER_SIZE || std::memcmp(blob.constData(), LOADOUT_MAGIC, sizeof(LOADOUT_MAGIC)) != 0) {
+        return false;
+    }
+
+    uint16_t header[2];
+    std::memcpy(header, blob.constData() + sizeof(LOADOUT_MAGIC), sizeof(header));
+    if (header[0] != LOADOUT_VERSION || header[1] != INVENTORY_SLOT_COUNT ||
+        blob.size() != LOADOUT_HEADER_SIZE + INVENTORY_SLOT_COUNT) {
+        return false;
+    }
+
+    InventorySnapshot snapshot;
+    std::memcpy(snapshot.data(), blob.constData() + LOADOUT_HEADER_SIZE, snapshot.size());
+    restore(snapshot);
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <QByteArray>
+#include <array>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <cstdint>
+
+constexpr int INVENTORY_SLOT_COUNT = 768;
+constexpr uint8_t MAX_ITEM_COUNT = 99;
+
+using InventorySnapshot = std::array<uint8_t, INVENTORY_SLOT_COUNT>;
+
+struct InventoryChange {
+    int itemId;
+    uint8_t count;
+};
+
+// Native inventory edits. Reads and writes are queued onto the game thread
+// instead of looping through the script interpreter. Every write goes through
+// the game's setPlayerItemCount.
+namespace Inventory {
+    using CaptureCallback = std::function<void(const std::optional<InventorySnapshot>& snapshot)>;
+
+    // Raises every item that exists to count, capped at MAX_ITEM_COUNT. Unused
+    // slots, the ones without a name, are left alone
+    void fillItems(uint8_t count);
+    void applyChanges(std::vector<InventoryChange> changes);
+    // Only the slots that differ from the current inventory are written
+    void restore(const InventorySnapshot& snapshot);
+
+    // Reads the inventory on the game thread and calls back there. Nullopt without a save
+    void capture(CaptureCallback callback);
+
+    // Loadout blob: "LTIV", u16 version, u16 slot count, then one count byte per slot
+    QByteArray exportLoadout(const InventorySnapshot& snapshot);
+    bool importLoadout(const QByteArray& blob);
+}
@@ -0,0 +1,15 @@
+#include "KeyboardNoclipInput.h"
+#define NOMINMAX
+#include <Windows.h>
+
+NoclipInput KeyboardNoclipInput::sample()
+{
+    NoclipInput input;
+    input.forward = (GetAsyncKeyState('W') & 0x8000) != 0;
+    input.back = (GetAsyncKeyState('S') & 0x8000) != 0;
+    input.left = (GetAsyncKeyState('A') & 0x8000) != 0;
+    input.right = (GetAsyncKeyState('D') & 0x8000) != 0;
+    input.up = (GetAsyncKeyState(VK_SPACE) & 0x8000) != 0;
+    input.down = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+    return input;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "NoclipIntegrator.h"
+
+// WASD, space and shift, read with GetAsyncKeyState
+class KeyboardNoclipInput : public NoclipInputSource {
+public:
+    NoclipInput sample() override;
+};
@@ -4,6 +4,14 @@
 #include <thread>
 #include <QLibrary>
 #include "Bindings.h"
+#include "Callbacks.h"
+#include "PatchRegistry.h"
+#include "Offsets.h"
+#include "LuaSymbols.h"
+#include "ScriptRunner.h"
+#include "util/OffsetCache.h"
+#include "util/SignatureBatch.h"
+#include "common/GameStrings.h"
 #include "ui/MainWindow.h"
 
 
@@ -76,17 +84,31 @@ void LunarTearPluginInit(const LunarTearAPI* api, LT_PluginHandle handle)
     }
 
 
-    LT_LuaCFunc fLoadString = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3d92b0); // luaB_loadstring
+    QString modBasePath = QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon"));
+    uintptr_t imageBase = LunarTear::Get().Game().GetProcessBaseAddress();
+    OffsetCache offsetCache(modBasePath + "/cache/offsets.json", hashImageHeaders(imageBase));
+
+    // Game offsets and patch sites are found in the same pass over the executable
+    SignatureBatch signatures;
+    Offsets::queueSignatures(modBasePath + "/resource/signatures.json", offsetCache, signatures);
+    PatchRegistry::instance().queueSignatures(modBasePath + "/resource/patches", offsetCache, signatures);
+    signatures.run(imageBase, offsetCache);
+
+    Offsets::resolve(offsetCache);
+    PatchRegistry::instance().resolve(offsetCache);
+    offsetCache.save();
+
+    LT_LuaCFunc fLoadString = (LT_LuaCFunc)Offsets::address(GameOffset::LuaLoadString); // luaB_loadstring
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_loadstring", fLoadString);
-    LT_LuaCFunc fPcall = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3d94f0); // luaB_pcall
+    LT_LuaCFunc fPcall = (LT_LuaCFunc)Offsets::address(GameOffset::LuaPcall); // luaB_pcall
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_pcall", fPcall);
-    LT_LuaCFunc fToString = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3d95c0); // luaB_tostring
+    LT_LuaCFunc fToString = (LT_LuaCFunc)Offsets::address(GameOffset::LuaToString); // luaB_tostring
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_tostring", fToString);
-    LT_LuaCFunc fXpcall = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3d9550); // luaB_xpcall
+    LT_LuaCFunc fXpcall = (LT_LuaCFunc)Offsets::address(GameOffset::LuaXpcall); // luaB_xpcall
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_xpcall", fXpcall);
-    LT_LuaCFunc fType = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3d90c0); // luaB_type
+    LT_LuaCFunc fType = (LT_LuaCFunc)Offsets::address(GameOffset::LuaType); // luaB_type
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_type", fType);
-    LT_LuaCFunc fTable_getn = (LT_LuaCFunc)(LunarTear::Get().Game().GetProcessBaseAddress() + 0x3eb5d0); // table.getn
+    LT_LuaCFunc fTable_getn = (LT_LuaCFunc)Offsets::address(GameOffset::LuaTableGetn); // table.getn
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_table_getn", fTable_getn);
 
 
@@ -94,6 +116,17 @@ void LunarTearPluginInit(const LunarTearAPI* api, LT_PluginHandle handle)
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_SetCommandResult", Binding_SetCommandResult);
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_PostStartMessage", Binding_PostStartMessage);
     LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_PostLoadMessage", Binding_PostLoadMessage);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_GetNearestActor", Binding_GetNearestActor);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_GetActorsInRadius", Binding_GetActorsInRadius);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_WatchAdd", Binding_WatchAdd);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_WatchRemove", Binding_WatchRemove);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_WatchStats", Binding_WatchStats);
+    LunarTear::Get().RegisterLuaCFunc("_ifaifa_LTCon_WatchEvents", Binding_WatchEvents);
+
+    registerPostLoadCallback(PrewarmGameStrings);
+    registerPostLoadCallback([]() { LuaSymbolIndex::instance().refresh(); });
+    registerPostLoadCallback([]() { ScriptRunner::instance().invalidatePhaseState(); });
+    startFrameCallbackPump();
 
     LunarTear::Get().Log(LT_LOG_VERBOSE) << "LTConsole setup complete";
 
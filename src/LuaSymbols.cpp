@@ -0,0 +1,301 @@
+#include "LuaSymbols.h"
+#include "GameData.h"
+#include "util/SignatureScanner.h"
+#include <LunarTear++.h>
+#include <QRegularExpression>
+
+namespace {
+    constexpr size_t MAX_NAME_LENGTH = 64;
+    // Names per concatenation statement in the probe, well under the Lua register limit
+    constexpr int PROBE_NAMES_PER_STATEMENT = 32;
+
+    const char* const KEYWORDS[] = {
+        "and", "break", "do", "else", "elseif", "end", "false", "for", "function", "if", "in",
+        "local", "nil", "not", "or", "repeat", "return", "then", "true", "until", "while"
+    };
+
+    // Lua 5.0 library names, the probe finds out which ones the phase state actually has
+    const char* const LIBRARY_NAMES[] = {
+        "assert", "error", "getn", "ipairs", "loadstring", "next", "pairs", "pcall", "print",
+        "rawget", "rawset", "select", "setmetatable", "getmetatable", "tonumber", "tostring", "type", "unpack", "xpcall",
+        "string", "string.byte", "string.char", "string.find", "string.format", "string.gfind", "string.gsub",
+        "string.len", "string.lower", "string.rep", "string.sub", "string.upper",
+        "table", "table.concat", "table.foreach", "table.foreachi", "table.getn", "table.insert",
+        "table.remove", "table.setn", "table.sort",
+        "math", "math.abs", "math.acos", "math.asin", "math.atan", "math.atan2", "math.ceil", "math.cos",
+        "math.deg", "math.exp", "math.floor", "math.frexp", "math.ldexp", "math.log", "math.log10",
+        "math.max", "math.min", "math.mod", "math.pi", "math.pow", "math.rad", "math.random",
+        "math.randomseed", "math.sin", "math.sqrt", "math.tan",
+        "coroutine", "coroutine.create", "coroutine.resume", "coroutine.status", "coroutine.wrap", "coroutine.yield"
+    };
+
+    bool isIdentifierChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    bool isKeyword(const QString& name) {
+        for (const char* keyword : KEYWORDS) {
+            if (name == QLatin1String(keyword)) return true;
+        }
+        return false;
+    }
+
+    // Our own bindings are plumbing, not something to type at the console
+    bool isInternalName(const QString& name) {
+        return name.startsWith("_ifaifa_") || name.startsWith("ifaifa_");
+    }
+}
+
+LuaSymbolIndex& LuaSymbolIndex::instance()
+{
+    static LuaSymbolIndex s_instance;
+    return s_instance;
+}
+
+LuaSymbolIndex::LuaSymbolIndex()
+{
+    m_pool.setMaxThreadCount(1);
+    // Keywords complete before any phase has been probed
+    publish();
+}
+
+LuaSymbolIndex::~LuaSymbolIndex()
+{
+    m_pool.waitForDone();
+}
+
+QStringList LuaSymbolIndex::harvestImageNames()
+{
+    QStringList names;
+    uintptr_t base = LunarTear::Get().Game().GetProcessBaseAddress();
+
+    // Binding names are string literals of the form _ChangeMap, NUL terminated on both sides
+    for (const auto& section : getReadOnlyDataSections(base)) {
+        const char* data = reinterpret_cast<const char*>(section.start);
+        const size_t size = section.size;
+        size_t i = 0;
+        while (i + 1 < size) {
+            if (data[i] != '_' || (i > 0 && data[i - 1] != '\0') || !(data[i + 1] >= 'A' && data[i + 1] <= 'Z')) {
+                ++i;
+                continue;
+            }
+            size_t end = i + 1;
+            while (end < size && isIdentifierChar(data[end])) ++end;
+            if (end < size && data[end] == '\0' && end - i <= MAX_NAME_LENGTH) {
+                names.append(QString::fromLatin1(data + i, qsizetype(end - i)));
+            }
+            i = end;
+        }
+    }
+    return names;
+}
+
+QString LuaSymbolIndex::probeScript(const QStringList& names)
+{
+    // One character per name: '-' missing, 'f' function, 't' table, 'v' anything else
+    QString script = "local t = _ifaifa_LTCon_type\n"
+        "local function k(v)\n"
+        "local s = t(v)\n"
+        "if s == \"nil\" then return \"-\" elseif s == \"function\" then return \"f\" elseif s == \"table\" then return \"t\" end\n"
+        "return \"v\"\n"
+        "end\n"
+        "local r = \"\"\n";
+
+    for (int i = 0; i < names.size(); i += PROBE_NAMES_PER_STATEMENT) {
+        QStringList terms;
+        for (int j = i; j < qMin(i + PROBE_NAMES_PER_STATEMENT, int(names.size())); ++j) {
+            const QString& name = names[j];
+            const qsizetype dot = name.indexOf('.');
+            if (dot < 0) {
+                terms << QString("k(%1)").arg(name);
+            }
+            else {
+                // Indexing a missing table would fail the whole probe
+                terms << QString("k(t(%1) == \"table\" and %2 or nil)").arg(name.left(dot), name);
+            }
+        }
+        script += "r = r .. " + terms.join(" .. ") + "\n";
+    }
+    script += "return r\n";
+    return script;
+}
+
+void LuaSymbolIndex::addCandidate(const QString& name)
+{
+    if (name.isEmpty() || isKeyword(name) || isInternalName(name) || m_candidateSet.contains(name)) return;
+    m_candidateSet.insert(name);
+    m_candidates.append(name);
+}
+
+void LuaSymbolIndex::refresh()
+{
+    const QString phase = GameData::instance().getCurrentPhase();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_harvestStarted) {
+        m_harvestStarted = true;
+        for (const char* name : LIBRARY_NAMES) addCandidate(QString::fromLatin1(name));
+
+        // Walks every read-only section of the executable, too slow for the phase load it would stall
+        m_pool.start([this]() {
+            QStringList names = harvestImageNames();
+            LunarTear::Get().QueuePhaseUpdateCallback([this, names = std::move(names)]() {
+                onImageHarvested(names);
+            });
+        });
+    }
+
+    m_phase = phase;
+    publish();
+    probeMissing();
+}
+
+void LuaSymbolIndex::onImageHarvested(const QStringList& names)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const QString& name : names) addCandidate(name);
+    LunarTear::Get().Log(LT_LOG_VERBOSE) << "LuaSymbolIndex: " << m_candidates.size() << " completion candidates";
+
+    // Probed right away if no probe is in flight, otherwise once it returns
+    probeMissing();
+}
+
+void LuaSymbolIndex::probeMissing()
+{
+    if (m_probing || m_phase.isEmpty()) return;
+
+    const QSet<QString>& probed = m_probed[m_phase];
+    QStringList names;
+    for (const QString& name : m_candidates) {
+        if (!probed.contains(name)) names.append(name);
+    }
+    if (names.isEmpty()) return;
+
+    m_probing = true;
+    const QString phase = m_phase;
+    LunarTear::Get().QueuePhaseScriptExecution(probeScript(names).toStdString(), [this, phase, names](const LuaResult& result) {
+        if (result.IsError()) {
+            LunarTear::Get().Log(LT_LOG_WARNING) << "LuaSymbolIndex: probe failed: " << result.AsString();
+            onProbeResult(phase, names, QString());
+            return;
+        }
+        onProbeResult(phase, names, QString::fromStdString(result.AsString()));
+    });
+}
+
+void LuaSymbolIndex::onProbeResult(const QString& phase, const QStringList& names, const QString& flags)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_probing = false;
+
+    // Queued before a phase change and ran in the next phase, the new phase gets its own probe
+    if (phase != m_phase) {
+        probeMissing();
+        return;
+    }
+
+    // A failed probe isn't retried in this phase, it would fail the same way
+    QSet<QString>& probed = m_probed[phase];
+    for (const QString& name : names) probed.insert(name);
+    if (flags.size() != names.size()) return;
+
+    QHash<QString, LuaSymbolKind>& symbols = m_phaseSymbols[phase];
+    for (int i = 0; i < names.size(); ++i) {
+        switch (flags[i].toLatin1()) {
+        case 'f': symbols.insert(names[i], LuaSymbolKind::Function); break;
+        case 't': symbols.insert(names[i], LuaSymbolKind::Table); break;
+        case 'v': symbols.insert(names[i], LuaSymbolKind::Value); break;
+        default: break;
+        }
+    }
+    publish();
+
+    // Names learned while this probe was in flight
+    probeMissing();
+}
+
+void LuaSymbolIndex::learnFromCommand(const QString& command)
+{
+    static const QRegularExpression functionPattern(R"(\bfunction\s+([A-Za-z_]\w*(?:\.[A-Za-z_]\w*)?)\s*\()");
+    static const QRegularExpression assignPattern(R"((?:^|[^\w.])([A-Za-z_]\w*(?:\.[A-Za-z_]\w*)?)\s*=(?!=)\s*(\{)?)");
+    static const QRegularExpression localPattern(R"(\blocal\s+$)");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QHash<QString, LuaSymbolKind>& symbols = m_phaseSymbols[m_phase];
+    QSet<QString>& probed = m_probed[m_phase];
+    bool changed = false;
+
+    auto learn = [&](const QString& name, LuaSymbolKind kind) {
+        if (isKeyword(name) || isInternalName(name)) return;
+        addCandidate(name);
+        probed.insert(name);
+        if (symbols.value(name, LuaSymbolKind::Keyword) != kind) {
+            symbols.insert(name, kind);
+            changed = true;
+        }
+    };
+
+    auto functions = functionPattern.globalMatch(command);
+    while (functions.hasNext()) {
+        learn(functions.next().captured(1), LuaSymbolKind::Function);
+    }
+
+    auto assignments = assignPattern.globalMatch(command);
+    while (assignments.hasNext()) {
+        const QRegularExpressionMatch match = assignments.next();
+        // Locals die with the command's chunk
+        if (localPattern.match(command.left(match.capturedStart(1))).hasMatch()) continue;
+        learn(match.captured(1), match.hasCaptured(2) ? LuaSymbolKind::Table : LuaSymbolKind::Value);
+    }
+
+    if (changed) publish();
+}
+
+void LuaSymbolIndex::publish()
+{
+    auto snapshot = std::make_shared<Snapshot>();
+
+    std::vector<std::string> words;
+    for (const char* keyword : KEYWORDS) words.emplace_back(keyword);
+
+    const auto phaseIt = m_phaseSymbols.constFind(m_phase);
+    if (phaseIt != m_phaseSymbols.constEnd()) {
+        for (auto it = phaseIt->cbegin(); it != phaseIt->cend(); ++it) {
+            words.push_back(it.key().toStdString());
+        }
+    }
+    snapshot->trie.build(std::move(words));
+
+    snapshot->kinds.resize(snapshot->trie.size(), LuaSymbolKind::Keyword);
+    if (phaseIt != m_phaseSymbols.constEnd()) {
+        for (int i = 0; i < int(snapshot->trie.size()); ++i) {
+            snapshot->kinds[i] = phaseIt->value(QString::fromStdString(snapshot->trie.word(i)), LuaSymbolKind::Keyword);
+        }
+    }
+
+    m_snapshot = std::move(snapshot);
+}
+
+LuaCompletionResult LuaSymbolIndex::complete(const QString& prefix, int limit) const
+{
+    std::shared_ptr<const Snapshot> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        snapshot = m_snapshot;
+    }
+
+    LuaCompletionResult result;
+    if (!snapshot) return result;
+
+    const PrefixTrie::Range range = snapshot->trie.find(prefix.toStdString());
+    result.total = range.size();
+    if (range.isEmpty()) return result;
+
+    result.commonPrefix = QString::fromStdString(std::string(snapshot->trie.commonPrefix(range)));
+    const int count = qMin(range.size(), limit);
+    result.matches.reserve(count);
+    for (int i = range.begin; i < range.begin + count; ++i) {
+        result.matches.push_back(LuaCompletion{ QString::fromStdString(snapshot->trie.word(i)), snapshot->kinds[i] });
+    }
+    return result;
+}
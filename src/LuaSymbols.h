@@ -0,0 +1,82 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "util/PrefixTrie.h"
+
+enum class LuaSymbolKind : char { Keyword = 'k', Function = 'f', Table = 't', Value = 'v' };
+
+struct LuaCompletion {
+    QString name;
+    LuaSymbolKind kind;
+};
+
+struct LuaCompletionResult {
+    QString commonPrefix; // Shared by every match, at least as long as the query when anything matched
+    std::vector<LuaCompletion> matches; // Sorted, at most the requested limit
+    int total = 0;
+};
+
+// Names known to exist in the game's phase Lua state, for tab completion.
+//
+// The phase state has no base library, so its globals can't be walked from Lua.
+// Candidates come from the `_`-prefixed binding names in the game executable's
+// read-only data, the standard library tables, and whatever console commands
+// define. They are checked in one generated script per phase, and only names not
+// yet checked in that phase are sent again. The executable is scanned once, on a
+// worker; the game thread only queues probes. Lookups read an immutable snapshot
+// and never touch the game thread.
+class LuaSymbolIndex
+{
+public:
+    static LuaSymbolIndex& instance();
+
+    // Game thread, once a phase has loaded
+    void refresh();
+
+    // Globals and table fields a console command assigns or defines
+    void learnFromCommand(const QString& command);
+
+    LuaCompletionResult complete(const QString& prefix, int limit) const;
+
+private:
+    LuaSymbolIndex();
+    ~LuaSymbolIndex();
+
+    LuaSymbolIndex(const LuaSymbolIndex&) = delete;
+    LuaSymbolIndex& operator=(const LuaSymbolIndex&) = delete;
+
+    struct Snapshot {
+        PrefixTrie trie;
+        std::vector<LuaSymbolKind> kinds; // By trie word index
+    };
+
+    void addCandidate(const QString& name);
+    void onImageHarvested(const QStringList& names); // Game thread
+    void probeMissing(); // Requires m_mutex
+    void onProbeResult(const QString& phase, const QStringList& names, const QString& flags);
+    void publish(); // Requires m_mutex
+
+    static QStringList harvestImageNames();
+    static QString probeScript(const QStringList& names);
+
+    mutable std::mutex m_mutex;
+
+    bool m_harvestStarted = false;
+    QStringList m_candidates; // In discovery order
+    QSet<QString> m_candidateSet;
+
+    QString m_phase;
+    QHash<QString, QHash<QString, LuaSymbolKind>> m_phaseSymbols; // Names found per phase
+    QHash<QString, QSet<QString>> m_probed; // Names already checked per phase
+    bool m_probing = false;
+
+    std::shared_ptr<const Snapshot> m_snapshot;
+
+    QThreadPool m_pool;
+};
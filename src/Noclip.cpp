@@ -0,0 +1,82 @@
+#include "Noclip.h"
+#include "KeyboardNoclipInput.h"
+#include "GameData.h"
+#include "Offsets.h"
+#include <LunarTear++.h>
+
+namespace {
+    struct CameraMatrix {
+        float m[4][4];
+    };
+
+    const CameraMatrix* getCameraMatrix() {
+        if (!LunarTear::Get().Game().GetProcessBaseAddress()) return nullptr;
+        uintptr_t camManagerAddr = Offsets::address(GameOffset::CameraManager);
+        return (const CameraMatrix*)(camManagerAddr + 0x240);
+    }
+}
+
+NoclipController& NoclipController::instance()
+{
+    static NoclipController s_instance;
+    return s_instance;
+}
+
+NoclipController::NoclipController()
+    : m_input(std::make_unique<KeyboardNoclipInput>())
+{
+}
+
+void NoclipController::setInputSource(std::unique_ptr<NoclipInputSource> source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_input = std::move(source);
+}
+
+void NoclipController::setEnabled(bool enabled)
+{
+    if (m_enabled.exchange(enabled) == enabled) return;
+
+    if (enabled) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_integrator.reset();
+        }
+        m_frameCallbackId = registerFrameCallback([this](float deltaSeconds) { onFrame(deltaSeconds); });
+    }
+    else {
+        unregisterFrameCallback(m_frameCallbackId);
+        m_frameCallbackId = 0;
+    }
+}
+
+void NoclipController::onFrame(float deltaSeconds)
+{
+    if (!m_enabled.load() || !GameData::instance().isGameActive()) {
+        return;
+    }
+
+    ActorPlayable* player = LunarTear::Get().Game().GetActorPlayable();
+    const CameraMatrix* cameraMatrix = getCameraMatrix();
+
+    if (!player || !cameraMatrix) {
+        return;
+    }
+
+    QVector3D forward(cameraMatrix->m[0][2], cameraMatrix->m[1][2], cameraMatrix->m[2][2]);
+    QVector3D right(cameraMatrix->m[0][0], cameraMatrix->m[1][0], cameraMatrix->m[2][0]);
+
+    QVector3D move;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_input) return;
+        m_integrator.setSpeed(m_speed.load());
+        move = m_integrator.step(m_input->sample(), forward, right, deltaSeconds);
+    }
+
+    if (move.isNull()) return;
+
+    player->posX += move.x();
+    player->posY += move.y();
+    player->posZ += move.z();
+}
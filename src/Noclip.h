@@ -0,0 +1,36 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "Callbacks.h"
+#include "NoclipIntegrator.h"
+
+class NoclipController
+{
+public:
+    static constexpr float DEFAULT_SPEED = NoclipIntegrator::DEFAULT_SPEED;
+
+    static NoclipController& instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(); }
+
+    void setSpeed(float unitsPerSecond) { m_speed.store(unitsPerSecond); }
+    void setInputSource(std::unique_ptr<NoclipInputSource> source);
+
+private:
+    NoclipController();
+    ~NoclipController() = default;
+    NoclipController(const NoclipController&) = delete;
+    NoclipController& operator=(const NoclipController&) = delete;
+
+    void onFrame(float deltaSeconds);
+
+    std::atomic<bool> m_enabled = false;
+    std::atomic<float> m_speed = DEFAULT_SPEED;
+    CallbackId m_frameCallbackId = 0;
+
+    std::mutex m_mutex;
+    std::unique_ptr<NoclipInputSource> m_input;
+    NoclipIntegrator m_integrator;
+};
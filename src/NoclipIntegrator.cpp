@@ -0,0 +1,27 @@
+#include "NoclipIntegrator.h"
+#include <cmath>
+
+QVector3D NoclipIntegrator::step(const NoclipInput& input, const QVector3D& cameraForward, const QVector3D& cameraRight, float deltaSeconds)
+{
+    const QVector3D worldUp(0.0f, 1.0f, 0.0f);
+
+    QVector3D direction;
+    if (input.forward) direction += cameraForward;
+    if (input.back) direction -= cameraForward;
+    if (input.left) direction += cameraRight;
+    if (input.right) direction -= cameraRight;
+    if (input.up) direction += worldUp;
+    if (input.down) direction -= worldUp;
+
+    QVector3D targetVelocity = direction.isNull() ? QVector3D() : direction.normalized() * m_speed;
+
+    // Exponential ease so the result doesn't depend on how the frame time is sliced
+    float blend = 1.0f - std::exp(-m_responsiveness * deltaSeconds);
+    m_velocity += (targetVelocity - m_velocity) * blend;
+
+    if (targetVelocity.isNull() && m_velocity.lengthSquared() < 1e-4f) {
+        m_velocity = QVector3D();
+    }
+
+    return m_velocity * deltaSeconds;
+}
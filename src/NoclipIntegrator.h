@@ -0,0 +1,38 @@
+#pragma once
+#include <QVector3D>
+
+struct NoclipInput {
+    bool forward = false;
+    bool back = false;
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+};
+
+// Where movement intent comes from. Sampled once per frame on the game thread
+class NoclipInputSource {
+public:
+    virtual ~NoclipInputSource() = default;
+    virtual NoclipInput sample() = 0;
+};
+
+// Pure movement integrator with no game or platform dependencies.
+// Velocity eases toward the input direction, so motion is independent of frame rate
+class NoclipIntegrator {
+public:
+    // Units per second, matching the old fixed 16ms step
+    static constexpr float DEFAULT_SPEED = 62.5f;
+
+    void setSpeed(float unitsPerSecond) { m_speed = unitsPerSecond; }
+    void setResponsiveness(float perSecond) { m_responsiveness = perSecond; }
+    void reset() { m_velocity = QVector3D(); }
+
+    // Returns the displacement to apply this frame
+    QVector3D step(const NoclipInput& input, const QVector3D& cameraForward, const QVector3D& cameraRight, float deltaSeconds);
+
+private:
+    float m_speed = DEFAULT_SPEED;
+    float m_responsiveness = 12.0f;
+    QVector3D m_velocity;
+};
@@ -0,0 +1,102 @@
+#include "Offsets.h"
+#include "util/SignatureBatch.h"
+#include "util/OffsetCache.h"
+#include <LunarTear++.h>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <array>
+#include <cstring>
+
+namespace {
+    constexpr size_t OFFSET_COUNT = static_cast<size_t>(GameOffset::Count);
+
+    struct KnownOffset {
+        const char* name;
+        uintptr_t fallbackRva;
+    };
+
+    constexpr std::array<KnownOffset, OFFSET_COUNT> knownOffsets = { {
+        { "CameraManager", 0x32e7a00 },
+        { "WeaponSpecs", 0x47c2670 },
+        { "ActorManager", 0x2ca6e00 },
+        { "LuaLoadString", 0x3d92b0 }, // luaB_loadstring
+        { "LuaPcall", 0x3d94f0 },      // luaB_pcall
+        { "LuaToString", 0x3d95c0 },   // luaB_tostring
+        { "LuaXpcall", 0x3d9550 },     // luaB_xpcall
+        { "LuaType", 0x3d90c0 },       // luaB_type
+        { "LuaTableGetn", 0x3eb5d0 }   // table.getn
+    } };
+
+    std::array<uintptr_t, OFFSET_COUNT> makeFallbacks() {
+        std::array<uintptr_t, OFFSET_COUNT> rvas{};
+        for (size_t i = 0; i < OFFSET_COUNT; ++i) rvas[i] = knownOffsets[i].fallbackRva;
+        return rvas;
+    }
+
+    std::array<uintptr_t, OFFSET_COUNT> g_rvas = makeFallbacks();
+
+    // Cache key of every offset with a signature, empty for the rest
+    std::array<QString, OFFSET_COUNT> g_cacheKeys;
+}
+
+void Offsets::queueSignatures(const QString& signatureFile, const OffsetCache& cache, SignatureBatch& batch)
+{
+    QFile file(signatureFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+    const uintptr_t base = LunarTear::Get().Game().GetProcessBaseAddress();
+
+    for (size_t i = 0; i < OFFSET_COUNT; ++i) {
+        QJsonObject entry = root[knownOffsets[i].name].toObject();
+        QString text = entry["signature"].toString();
+        if (text.isEmpty()) continue;
+
+        auto signature = parseSignature(text.toStdString());
+        if (!signature) {
+            qWarning() << "Offsets: Invalid signature for" << knownOffsets[i].name;
+            continue;
+        }
+
+        const int64_t offset = entry["offset"].toInteger(0);
+        const bool relative = entry["relative"].toBool(false);
+        const int64_t instructionEnd = entry["instructionEnd"].toInteger(offset + int64_t(sizeof(int32_t)));
+        QString key = QString("offset:%1:%2+%3").arg(knownOffsets[i].name, text).arg(offset);
+        if (relative) key += QString("r%1").arg(instructionEnd);
+        g_cacheKeys[i] = key;
+
+        batch.add(cache, key, std::move(*signature), [base, offset, relative, instructionEnd](uintptr_t match) {
+            if (!relative) return uintptr_t(match + offset);
+            int32_t displacement;
+            std::memcpy(&displacement, reinterpret_cast<const void*>(base + match + offset), sizeof(displacement));
+            return uintptr_t(match + instructionEnd + displacement);
+        });
+    }
+}
+
+void Offsets::resolve(const OffsetCache& cache)
+{
+    for (size_t i = 0; i < OFFSET_COUNT; ++i) {
+        if (g_cacheKeys[i].isEmpty()) continue;
+        if (auto rva = cache.lookup(g_cacheKeys[i])) {
+            g_rvas[i] = *rva;
+        }
+        else {
+            qWarning() << "Offsets: Signature not found for" << knownOffsets[i].name << "- using built-in RVA";
+        }
+    }
+}
+
+uintptr_t Offsets::rva(GameOffset offset)
+{
+    return g_rvas[static_cast<size_t>(offset)];
+}
+
+uintptr_t Offsets::address(GameOffset offset)
+{
+    return LunarTear::Get().Game().GetProcessBaseAddress() + rva(offset);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <QString>
+#include <cstdint>
+
+class OffsetCache;
+class SignatureBatch;
+
+enum class GameOffset {
+    CameraManager,
+    WeaponSpecs,
+    ActorManager,
+    LuaLoadString,
+    LuaPcall,
+    LuaToString,
+    LuaXpcall,
+    LuaType,
+    LuaTableGetn,
+    Count
+};
+
+// Game RVAs resolved from signatures at startup. Anything without a signature,
+// or whose signature doesn't match, keeps the RVA known for the current game version.
+//
+// Signature file, keyed by GameOffset name:
+//   { "CameraManager": { "signature": "48 8D 0D ?? ?? ?? ?? E8", "offset": 3, "relative": true } }
+// "offset" is added to the match. With "relative" the int32 found there is treated
+// as a RIP-relative displacement and the target it points to is used instead. The
+// displacement counts from the end of the instruction, which is "instructionEnd"
+// bytes from the match; it defaults to right after the displacement and has to be
+// given for forms with a trailing immediate such as cmp [rip+x], imm8.
+namespace Offsets {
+    // Queues the signatures of offsets the cache doesn't know yet, so they are
+    // found in the same pass over the image as everything else
+    void queueSignatures(const QString& signatureFile, const OffsetCache& cache, SignatureBatch& batch);
+    // Takes the offsets from the cache once the batch has run
+    void resolve(const OffsetCache& cache);
+
+    uintptr_t rva(GameOffset offset);
+    uintptr_t address(GameOffset offset);
+}
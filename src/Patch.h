@@ -1,5 +1,2 @@
-void PatchInfiniteJump();
-void UnpatchInfiniteJump();
-
-void PatchNoMove();
-void UnpatchNoMove();
\ No newline at end of file
+bool PatchNoMove();
+bool UnpatchNoMove();
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "PatchRegistry.h"
+#include "util/SignatureBatch.h"
+#include "util/OffsetCache.h"
+#include <LunarTear++.h>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+#include <span>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    std::vector<PatchDefinition> builtInDefinitions() {
+        PatchDefinition infiniteJump;
+        infiniteJump.id = "infinite_jump";
+        infiniteJump.name = "Infinite Jump";
+        infiniteJump.sites = {
+            { 0x6A007A, {}, 0, {0x90, 0x90}, {0x84, 0xC0} }
+        };
+
+        // Stops the game driving the player position, used by noclip
+        PatchDefinition noMove;
+        noMove.id = "no_move";
+        noMove.name = "Freeze Player Movement";
+        noMove.showInToolbox = false;
+        noMove.sites = {
+            { 0xe48f0, {}, 0, {0xc3, 0x90}, {} },
+            { 0x6742f0, {}, 0, {0xc3, 0x90, 0x90, 0x90, 0x90}, {} },
+            { 0xdbf10, {}, 0, {0xc3, 0x90}, {} },
+            { 0x669670, {}, 0, {0xc3, 0x90}, {} },
+            { 0x068d680, {}, 0, {0xc3, 0x90, 0x90}, {} }
+        };
+
+        return { infiniteJump, noMove };
+    }
+
+    std::optional<std::vector<uint8_t>> parseBytes(const QString& text) {
+        std::vector<uint8_t> bytes;
+        for (const QString& token : text.split(' ', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            uint value = token.toUInt(&ok, 16);
+            if (!ok || value > 0xFF) return std::nullopt;
+            bytes.push_back(static_cast<uint8_t>(value));
+        }
+        return bytes;
+    }
+
+    std::optional<PatchDefinition> parseDefinition(const QJsonObject& obj, const QString& source) {
+        PatchDefinition def;
+        def.id = obj["id"].toString();
+        def.name = obj["name"].toString(def.id);
+        def.description = obj["description"].toString();
+        def.showInToolbox = obj["toolbox"].toBool(true);
+
+        if (def.id.isEmpty()) {
+            qWarning() << "PatchRegistry:" << source << "has a patch without an id";
+            return std::nullopt;
+        }
+
+        for (const QJsonValue& val : obj["sites"].toArray()) {
+            QJsonObject siteObj = val.toObject();
+            PatchSite site;
+
+            if (siteObj.contains("offset")) {
+                bool ok = false;
+                site.offset = siteObj["offset"].toString().toULongLong(&ok, 16);
+                if (!ok) {
+                    qWarning() << "PatchRegistry:" << def.id << "has an invalid offset";
+                    return std::nullopt;
+                }
+            }
+            else {
+                site.signature = siteObj["signature"].toString();
+                site.signatureOffset = siteObj["signatureOffset"].toInteger(0);
+                if (site.signature.isEmpty()) {
+                    qWarning() << "PatchRegistry:" << def.id << "has a site with no offset or signature";
+                    return std::nullopt;
+                }
+            }
+
+            auto patchBytes = parseBytes(siteObj["bytes"].toString());
+            auto originalBytes = parseBytes(siteObj["original"].toString());
+            if (!patchBytes || patchBytes->empty() || !originalBytes ||
+                (!originalBytes->empty() && originalBytes->size() != patchBytes->size())) {
+                qWarning() << "PatchRegistry:" << def.id << "has invalid patch bytes";
+                return std::nullopt;
+            }
+            site.patchBytes = std::move(*patchBytes);
+            site.originalBytes = std::move(*originalBytes);
+
+            def.sites.push_back(std::move(site));
+        }
+
+        if (def.sites.empty()) {
+            qWarning() << "PatchRegistry:" << def.id << "has no sites";
+            return std::nullopt;
+        }
+        return def;
+    }
+
+    std::vector<PatchDefinition> loadDefinitionFiles(const QString& directory) {
+        std::vector<PatchDefinition> definitions;
+
+        QDir dir(directory);
+        for (const QString& fileName : dir.entryList({ "*.json" }, QDir::Files, QDir::Name)) {
+            QFile file(dir.filePath(fileName));
+            if (!file.open(QIODevice::ReadOnly)) {
+                qWarning() << "PatchRegistry: Could not open" << file.fileName();
+                continue;
+            }
+
+            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+            QJsonArray items = doc.isArray() ? doc.array() : QJsonArray{ doc.object() };
+            for (const QJsonValue& item : items) {
+                if (auto def = parseDefinition(item.toObject(), fileName)) {
+                    definitions.push_back(std::move(*def));
+                }
+            }
+        }
+        return definitions;
+    }
+
+    QString cacheKey(const PatchSite& site) {
+        return QString("%1+%2").arg(site.signature).arg(site.signatureOffset);
+    }
+
+    // Original bytes for a site that doesn't list them. Taken from the image the
+    // first time it is seen and kept in the offset cache while the image hash stays
+    // the same, so a later apply still notices code that changed under it. Nullopt
+    // if the site already holds the patch and there is nothing to pin
+    std::optional<std::vector<uint8_t>> pinnedOriginalBytes(OffsetCache& cache, uintptr_t base, uintptr_t rva, const std::vector<uint8_t>& patchBytes) {
+        const qsizetype size = static_cast<qsizetype>(patchBytes.size());
+        const QString key = QString("%1:%2").arg(rva, 0, 16).arg(size);
+
+        auto pinned = cache.lookupBytes(key);
+        if (!pinned || pinned->size() != size) {
+            QByteArray current(reinterpret_cast<const char*>(base + rva), size);
+            if (std::memcmp(current.constData(), patchBytes.data(), patchBytes.size()) == 0) return std::nullopt;
+            cache.storeBytes(key, current);
+            pinned = current;
+        }
+        return std::vector<uint8_t>(pinned->begin(), pinned->end());
+    }
+}
+
+PatchRegistry& PatchRegistry::instance()
+{
+    static PatchRegistry s_instance;
+    return s_instance;
+}
+
+void PatchRegistry::queueSignatures(const QString& patchDirectory, const OffsetCache& cache, SignatureBatch& batch)
+{
+    std::vector<PatchDefinition> definitions = builtInDefinitions();
+    for (auto& def : loadDefinitionFiles(patchDirectory)) {
+        auto existing = std::find_if(definitions.begin(), definitions.end(), [&](const PatchDefinition& d) { return d.id == def.id; });
+        if (existing != definitions.end()) {
+            *existing = std::move(def);
+        }
+        else {
+            definitions.push_back(std::move(def));
+        }
+    }
+
+    for (const auto& def : definitions) {
+        for (const auto& site : def.sites) {
+            if (site.offset) continue;
+            if (auto signature = parseSignature(site.signature.toStdString())) {
+                const int64_t adjust = site.signatureOffset;
+                batch.add(cache, cacheKey(site), std::move(*signature), [adjust](uintptr_t match) { return uintptr_t(match + adjust); });
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingDefinitions = std::move(definitions);
+}
+
+void PatchRegistry::resolve(OffsetCache& cache)
+{
+    std::vector<PatchDefinition> definitions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        definitions = std::move(m_pendingDefinitions);
+        m_pendingDefinitions.clear();
+    }
+
+    const uintptr_t base = LunarTear::Get().Game().GetProcessBaseAddress();
+
+    std::vector<Entry> entries;
+    for (auto& def : definitions) {
+        Entry entry;
+        auto patches = std::make_unique<PatchSet>();
+
+        for (const auto& site : def.sites) {
+            std::optional<uintptr_t> rva = site.offset ? site.offset : cache.lookup(cacheKey(site));
+            if (!rva) {
+                entry.error = QString("Signature not found: %1").arg(site.signature);
+                qWarning() << "PatchRegistry:" << def.id << entry.error;
+                patches.reset();
+                break;
+            }
+            std::vector<uint8_t> expected = site.originalBytes;
+            if (expected.empty()) {
+                auto pinned = pinnedOriginalBytes(cache, base, *rva, site.patchBytes);
+                if (!pinned) {
+                    entry.error = QString("Already patched at 0x%1").arg(*rva, 0, 16);
+                    qWarning() << "PatchRegistry:" << def.id << entry.error;
+                    patches.reset();
+                    break;
+                }
+                expected = std::move(*pinned);
+            }
+            patches->add(base + *rva, site.patchBytes, std::move(expected));
+        }
+
+        entry.definition = std::move(def);
+        entry.patches = std::move(patches);
+        entries.push_back(std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries = std::move(entries);
+}
+
+std::vector<PatchDefinition> PatchRegistry::definitions() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<PatchDefinition> result;
+    result.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        result.push_back(entry.definition);
+    }
+    return result;
+}
+
+PatchRegistry::Entry* PatchRegistry::find(const QString& id)
+{
+    for (auto& entry : m_entries) {
+        if (entry.definition.id == id) return &entry;
+    }
+    return nullptr;
+}
+
+const PatchRegistry::Entry* PatchRegistry::find(const QString& id) const
+{
+    return const_cast<PatchRegistry*>(this)->find(id);
+}
+
+bool PatchRegistry::isAvailable(const QString& id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Entry* entry = find(id);
+    return entry && entry->patches;
+}
+
+QString PatchRegistry::errorString(const QString& id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Entry* entry = find(id);
+    return entry ? entry->error : QString("Unknown patch: %1").arg(id);
+}
+
+bool PatchRegistry::setEnabled(const QString& id, bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = find(id);
+    if (!entry || !entry->patches) return false;
+
+    auto result = enabled ? entry->patches->apply() : entry->patches->revert();
+    if (!result) {
+        entry->error = QString::fromStdString(result.error().message);
+        LunarTear::Get().Log(LT_LOG_ERROR) << id.toStdString() << ": " << result.error().message;
+        return false;
+    }
+    entry->error.clear();
+    return true;
+}
+
+bool PatchRegistry::isEnabled(const QString& id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Entry* entry = find(id);
+    return entry && entry->patches && entry->patches->isApplied();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <QString>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+#include "PatchSet.h"
+
+class OffsetCache;
+class SignatureBatch;
+
+// One write within a patch. The location is either a fixed RVA or a byte
+// signature, in which case signatureOffset is added to the match
+struct PatchSite {
+    std::optional<uintptr_t> offset;
+    QString signature;
+    int64_t signatureOffset = 0;
+    std::vector<uint8_t> patchBytes;
+    std::vector<uint8_t> originalBytes; // Empty pins what the unpatched image holds, see PatchRegistry::resolve
+};
+
+struct PatchDefinition {
+    QString id;
+    QString name;
+    QString description;
+    bool showInToolbox = true;
+    std::vector<PatchSite> sites;
+};
+
+// Patches described as data. Built-ins are always present; JSON files in the
+// patch directory add new ones or replace a built-in with the same id.
+//
+//   { "id": "infinite_jump", "name": "Infinite Jump",
+//     "sites": [ { "offset": "0x6A007A", "bytes": "90 90", "original": "84 C0" } ] }
+//
+// A site may give "signature": "84 C0 74 ??" and "signatureOffset" instead of "offset".
+// Sites without "original" are checked against the bytes found there the first
+// time the current image was loaded, kept in the offset cache.
+class PatchRegistry
+{
+public:
+    static PatchRegistry& instance();
+
+    // Reads definitions and queues the signatures of sites the cache doesn't know yet
+    void queueSignatures(const QString& patchDirectory, const OffsetCache& cache, SignatureBatch& batch);
+    // Builds the patches from the cache once the batch has run, pinning original bytes into it
+    void resolve(OffsetCache& cache);
+
+    std::vector<PatchDefinition> definitions() const;
+
+    bool isAvailable(const QString& id) const;
+    QString errorString(const QString& id) const;
+
+    bool setEnabled(const QString& id, bool enabled);
+    bool isEnabled(const QString& id) const;
+
+private:
+    PatchRegistry() = default;
+    ~PatchRegistry() = default;
+    PatchRegistry(const PatchRegistry&) = delete;
+    PatchRegistry& operator=(const PatchRegistry&) = delete;
+
+    struct Entry {
+        PatchDefinition definition;
+        std::unique_ptr<PatchSet> patches; // Null when a site couldn't be resolved
+        QString error;
+    };
+
+    Entry* find(const QString& id);
+    const Entry* find(const QString& id) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<PatchDefinition> m_pendingDefinitions; // Read by queueSignatures, taken by resolve
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,250 @@
+#include "PatchSet.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fstream>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+    class VirtualProtectBackend : public MemoryProtection {
+    public:
+        size_t pageSize() const override {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+        }
+
+        bool makeWritable(void* address, size_t size, uint32_t& oldProtect) override {
+            DWORD old = 0;
+            if (!VirtualProtect(address, size, PAGE_EXECUTE_READWRITE, &old)) return false;
+            oldProtect = old;
+            return true;
+        }
+
+        bool restore(void* address, size_t size, uint32_t oldProtect) override {
+            DWORD unused = 0;
+            return VirtualProtect(address, size, oldProtect, &unused) != 0;
+        }
+
+        void flushInstructionCache(void* address, size_t size) override {
+            FlushInstructionCache(GetCurrentProcess(), address, size);
+        }
+    };
+#else
+    // mprotect can't report the previous protection, so it is looked up in /proc/self/maps.
+    // -1 if the address isn't mapped
+    int currentProtection(uintptr_t address) {
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        while (std::getline(maps, line)) {
+            std::istringstream fields(line);
+            uintptr_t start = 0, end = 0;
+            char dash = 0;
+            std::string perms;
+            if (!(fields >> std::hex >> start >> dash >> end >> perms) || perms.size() < 3) continue;
+            if (address < start || address >= end) continue;
+
+            int protection = PROT_NONE;
+            if (perms[0] == 'r') protection |= PROT_READ;
+            if (perms[1] == 'w') protection |= PROT_WRITE;
+            if (perms[2] == 'x') protection |= PROT_EXEC;
+            return protection;
+        }
+        return -1;
+    }
+
+    class MprotectBackend : public MemoryProtection {
+    public:
+        size_t pageSize() const override {
+            return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+
+        // Ranges are single pages, so one lookup covers the whole range
+        bool makeWritable(void* address, size_t size, uint32_t& oldProtect) override {
+            const int protection = currentProtection(reinterpret_cast<uintptr_t>(address));
+            if (protection < 0) return false;
+            oldProtect = static_cast<uint32_t>(protection);
+            return mprotect(address, size, PROT_READ | PROT_WRITE | PROT_EXEC) == 0;
+        }
+
+        bool restore(void* address, size_t size, uint32_t oldProtect) override {
+            return mprotect(address, size, static_cast<int>(oldProtect)) == 0;
+        }
+
+        void flushInstructionCache(void* address, size_t size) override {
+            auto* begin = static_cast<char*>(address);
+            __builtin___clear_cache(begin, begin + size);
+        }
+    };
+#endif
+
+    std::string hex(uintptr_t value) {
+        std::ostringstream ss;
+        ss << "0x" << std::hex << value;
+        return ss.str();
+    }
+
+    MemoryProtection* sharedNativeProtection() {
+        static std::unique_ptr<MemoryProtection> s_protection = createNativeMemoryProtection();
+        return s_protection.get();
+    }
+}
+
+std::unique_ptr<MemoryProtection> createNativeMemoryProtection()
+{
+#ifdef _WIN32
+    return std::make_unique<VirtualProtectBackend>();
+#else
+    return std::make_unique<MprotectBackend>();
+#endif
+}
+
+PatchSet::PatchSet(MemoryProtection* protection)
+    : m_protection(protection ? protection : sharedNativeProtection())
+{
+}
+
+void PatchSet::add(uintptr_t address, std::vector<uint8_t> patchBytes, std::vector<uint8_t> expectedBytes)
+{
+    if (patchBytes.empty()) return;
+    m_entries.push_back(Entry{ address, std::move(patchBytes), std::move(expectedBytes), {} });
+}
+
+std::vector<PatchSet::PageRange> PatchSet::collectPageRanges() const
+{
+    const uintptr_t pageSize = m_protection->pageSize();
+
+    // One range per page, pages of one run can differ in protection and each is restored to its own
+    std::vector<PageRange> pages;
+    pages.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        uintptr_t start = entry.address & ~(pageSize - 1);
+        uintptr_t end = (entry.address + entry.patchBytes.size() + pageSize - 1) & ~(pageSize - 1);
+        for (uintptr_t page = start; page < end; page += pageSize) {
+            pages.push_back(PageRange{ page, pageSize });
+        }
+    }
+
+    std::sort(pages.begin(), pages.end(), [](const PageRange& a, const PageRange& b) { return a.start < b.start; });
+    pages.erase(std::unique(pages.begin(), pages.end(), [](const PageRange& a, const PageRange& b) { return a.start == b.start; }), pages.end());
+    return pages;
+}
+
+std::expected<void, PatchError> PatchSet::unprotect(std::vector<PageRange>& ranges)
+{
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        auto& range = ranges[i];
+        if (!m_protection->makeWritable(reinterpret_cast<void*>(range.start), range.size, range.oldProtect)) {
+            reprotect(std::vector<PageRange>(ranges.begin(), ranges.begin() + i));
+            return std::unexpected(PatchError{ PatchErrorCode::ProtectionFailed,
+                "Could not make " + hex(range.start) + " (+" + hex(range.size) + ") writable" });
+        }
+    }
+    return {};
+}
+
+void PatchSet::reprotect(const std::vector<PageRange>& ranges)
+{
+    for (const auto& range : ranges) {
+        m_protection->restore(reinterpret_cast<void*>(range.start), range.size, range.oldProtect);
+        m_protection->flushInstructionCache(reinterpret_cast<void*>(range.start), range.size);
+    }
+}
+
+bool PatchSet::holdsPatch(size_t index) const
+{
+    const auto& entry = m_entries[index];
+    for (size_t offset = 0; offset < entry.patchBytes.size(); ++offset) {
+        const uintptr_t address = entry.address + offset;
+        // Bytes a later patch overwrote are that patch's to check
+        const bool overwritten = std::any_of(m_entries.begin() + index + 1, m_entries.end(), [address](const Entry& later) {
+            return address >= later.address && address < later.address + later.patchBytes.size();
+        });
+        if (!overwritten && *reinterpret_cast<const uint8_t*>(address) != entry.patchBytes[offset]) return false;
+    }
+    return true;
+}
+
+std::expected<void, PatchError> PatchSet::apply()
+{
+    if (m_applied || m_entries.empty()) return {};
+
+    // Nothing is touched unless every patch site still holds what we expect
+    for (const auto& entry : m_entries) {
+        if (entry.expectedBytes.empty()) continue;
+        if (entry.expectedBytes.size() != entry.patchBytes.size() ||
+            std::memcmp(reinterpret_cast<const void*>(entry.address), entry.expectedBytes.data(), entry.expectedBytes.size()) != 0) {
+            return std::unexpected(PatchError{ PatchErrorCode::OriginalBytesMismatch,
+                "Unexpected original bytes at " + hex(entry.address) });
+        }
+    }
+
+    std::vector<PageRange> ranges = collectPageRanges();
+    if (auto result = unprotect(ranges); !result) {
+        return result;
+    }
+
+    for (auto& entry : m_entries) {
+        void* addr = reinterpret_cast<void*>(entry.address);
+        entry.savedBytes.assign(static_cast<const uint8_t*>(addr), static_cast<const uint8_t*>(addr) + entry.patchBytes.size());
+        std::memcpy(addr, entry.patchBytes.data(), entry.patchBytes.size());
+    }
+    reprotect(ranges);
+
+    // Read back once the original protection is in place again, so a page that didn't keep the write is caught
+    const Entry* failed = nullptr;
+    for (size_t i = 0; i < m_entries.size() && !failed; ++i) {
+        if (!holdsPatch(i)) failed = &m_entries[i];
+    }
+
+    if (failed) {
+        const std::string message = "Write did not stick at " + hex(failed->address);
+        if (unprotect(ranges)) {
+            // Roll back in reverse so overlapping patches unwind to the true original
+            for (size_t i = m_entries.size(); i-- > 0;) {
+                auto& entry = m_entries[i];
+                std::memcpy(reinterpret_cast<void*>(entry.address), entry.savedBytes.data(), entry.savedBytes.size());
+            }
+            reprotect(ranges);
+        }
+        return std::unexpected(PatchError{ PatchErrorCode::VerificationFailed, message });
+    }
+
+    m_applied = true;
+    return {};
+}
+
+std::expected<void, PatchError> PatchSet::revert()
+{
+    if (!m_applied) return {};
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (!holdsPatch(i)) {
+            return std::unexpected(PatchError{ PatchErrorCode::OriginalBytesMismatch,
+                "Patch at " + hex(m_entries[i].address) + " was modified externally" });
+        }
+    }
+
+    std::vector<PageRange> ranges = collectPageRanges();
+    if (auto result = unprotect(ranges); !result) {
+        return result;
+    }
+
+    for (size_t i = m_entries.size(); i-- > 0;) {
+        auto& entry = m_entries[i];
+        std::memcpy(reinterpret_cast<void*>(entry.address), entry.savedBytes.data(), entry.savedBytes.size());
+    }
+
+    reprotect(ranges);
+    m_applied = false;
+    return {};
+}
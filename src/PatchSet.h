@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <expected>
+
+// Page protection backend. Kept behind an interface so the engine doesn't depend on the game process
+class MemoryProtection {
+public:
+    virtual ~MemoryProtection() = default;
+
+    virtual size_t pageSize() const = 0;
+
+    // Makes [address, address + size) writable, returning whatever restore() needs
+    virtual bool makeWritable(void* address, size_t size, uint32_t& oldProtect) = 0;
+    virtual bool restore(void* address, size_t size, uint32_t oldProtect) = 0;
+
+    virtual void flushInstructionCache(void* /*address*/, size_t /*size*/) {}
+};
+
+// VirtualProtect on Windows, mprotect elsewhere
+std::unique_ptr<MemoryProtection> createNativeMemoryProtection();
+
+enum class PatchErrorCode {
+    Success,
+    OriginalBytesMismatch,
+    ProtectionFailed,
+    VerificationFailed
+};
+
+struct PatchError {
+    PatchErrorCode code;
+    std::string message;
+};
+
+// A group of byte patches applied and reverted as one unit.
+// Protection is flipped once per touched page, expected bytes are checked
+// before anything is written, and a failed write restores every byte already changed.
+class PatchSet {
+public:
+    // protection must outlive the set. nullptr uses a shared native backend
+    explicit PatchSet(MemoryProtection* protection = nullptr);
+
+    void add(uintptr_t address, std::vector<uint8_t> patchBytes, std::vector<uint8_t> expectedBytes = {});
+
+    std::expected<void, PatchError> apply();
+    std::expected<void, PatchError> revert();
+
+    bool isApplied() const { return m_applied; }
+    bool isEmpty() const { return m_entries.empty(); }
+
+private:
+    struct Entry {
+        uintptr_t address;
+        std::vector<uint8_t> patchBytes;
+        std::vector<uint8_t> expectedBytes;
+        std::vector<uint8_t> savedBytes;
+    };
+
+    struct PageRange {
+        uintptr_t start;
+        size_t size;
+        uint32_t oldProtect = 0;
+    };
+
+    std::vector<PageRange> collectPageRanges() const;
+    std::expected<void, PatchError> unprotect(std::vector<PageRange>& ranges);
+    void reprotect(const std::vector<PageRange>& ranges);
+    // Whether memory holds the entry's bytes, except where a later entry wrote over them
+    bool holdsPatch(size_t index) const;
+
+    MemoryProtection* m_protection;
+    std::vector<Entry> m_entries;
+    bool m_applied = false;
+};
@@ -0,0 +1,290 @@
+#include "SaveStates.h"
+#include "GameData.h"
+#include "Callbacks.h"
+#include <LunarTear++.h>
+#include <QFile>
+#include <QDataStream>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+    constexpr char FILE_MAGIC[4] = { 'L', 'T', 'S', 'S' };
+    constexpr quint32 FILE_VERSION = 1;
+
+#pragma pack(push, 1)
+    struct ParamStats {
+        int maxHP;
+        float maxMP;
+        int attack_stat;
+        int magickAttack_stat;
+        int defense_stat;
+        int magickDefense_stat;
+    };
+
+    struct RawState {
+        PlayerSaveData save;
+        ParamStats params;
+        float position[3];
+        float rotation[2];
+        uint8_t hasParams;
+        uint8_t hasPosition;
+    };
+#pragma pack(pop)
+
+    // Where the player is rather than what they have. Left untouched on restore,
+    // a map change puts the right values there
+    constexpr size_t LOCATION_BEGIN = offsetof(PlayerSaveData, current_phase);
+    constexpr size_t LOCATION_END = offsetof(PlayerSaveData, field4_0x28);
+
+    // Game thread only
+    std::optional<RawState> captureRaw() {
+        PlayerSaveData* save = LunarTear::Get().Game().GetPlayerSaveData();
+        if (!save) return std::nullopt;
+
+        RawState state{};
+        std::memcpy(&state.save, save, sizeof(PlayerSaveData));
+
+        if (CPlayerParam* params = LunarTear::Get().Game().GetPlayerParam()) {
+            state.params = { params->maxHP, params->maxMP, params->attack_stat,
+                params->magickAttack_stat, params->defense_stat, params->magickDefense_stat };
+            state.hasParams = 1;
+        }
+
+        if (ActorPlayable* actor = LunarTear::Get().Game().GetActorPlayable()) {
+            state.position[0] = actor->posX;
+            state.position[1] = actor->posY;
+            state.position[2] = actor->posZ;
+            state.rotation[0] = actor->rotationVal3;
+            state.rotation[1] = actor->rotationVal4;
+            state.hasPosition = 1;
+        }
+        return state;
+    }
+
+    // Game thread only
+    void applyRaw(const RawState& state) {
+        if (PlayerSaveData* save = LunarTear::Get().Game().GetPlayerSaveData()) {
+            auto* dst = reinterpret_cast<char*>(save);
+            auto* src = reinterpret_cast<const char*>(&state.save);
+            std::memcpy(dst, src, LOCATION_BEGIN);
+            std::memcpy(dst + LOCATION_END, src + LOCATION_END, sizeof(PlayerSaveData) - LOCATION_END);
+        }
+
+        CPlayerParam* params = LunarTear::Get().Game().GetPlayerParam();
+        if (params && state.hasParams) {
+            params->maxHP = state.params.maxHP;
+            params->maxMP = state.params.maxMP;
+            params->attack_stat = state.params.attack_stat;
+            params->magickAttack_stat = state.params.magickAttack_stat;
+            params->defense_stat = state.params.defense_stat;
+            params->magickDefense_stat = state.params.magickDefense_stat;
+        }
+
+        ActorPlayable* actor = LunarTear::Get().Game().GetActorPlayable();
+        if (actor && state.hasPosition) {
+            actor->posX = state.position[0];
+            actor->posY = state.position[1];
+            actor->posZ = state.position[2];
+            actor->rotationVal3 = state.rotation[0];
+            actor->rotationVal4 = state.rotation[1];
+        }
+    }
+
+    QString phaseOf(const RawState& state) {
+        return QString::fromUtf8(state.save.current_phase, strnlen(state.save.current_phase, sizeof(state.save.current_phase)));
+    }
+
+    // XOR against the baseline, then runs of (u16 zero count, u16 literal count, literals)
+    QByteArray encodeDelta(const RawState& state, const QByteArray& baseline) {
+        const auto* cur = reinterpret_cast<const uint8_t*>(&state);
+        const auto* base = reinterpret_cast<const uint8_t*>(baseline.constData());
+        const size_t size = sizeof(RawState);
+
+        QByteArray out;
+        size_t i = 0;
+        while (i < size) {
+            uint16_t zeros = 0;
+            while (i < size && zeros < 0xFFFF && cur[i] == base[i]) { ++i; ++zeros; }
+
+            size_t literalStart = i;
+            uint16_t literals = 0;
+            // A literal run ends at the first pair of matching bytes, a single match is cheaper inline
+            while (i < size && literals < 0xFFFF &&
+                !(cur[i] == base[i] && (i + 1 >= size || cur[i + 1] == base[i + 1]))) {
+                ++i;
+                ++literals;
+            }
+
+            out.append(reinterpret_cast<const char*>(&zeros), sizeof(zeros));
+            out.append(reinterpret_cast<const char*>(&literals), sizeof(literals));
+            for (size_t j = literalStart; j < literalStart + literals; ++j) {
+                out.append(static_cast<char>(cur[j] ^ base[j]));
+            }
+        }
+        return out;
+    }
+
+    std::optional<RawState> decodeDelta(const QByteArray& delta, const QByteArray& baseline) {
+        if (baseline.size() != sizeof(RawState)) return std::nullopt;
+
+        RawState state;
+        auto* out = reinterpret_cast<uint8_t*>(&state);
+        std::memcpy(out, baseline.constData(), sizeof(RawState));
+
+        const auto* in = reinterpret_cast<const uint8_t*>(delta.constData());
+        const size_t inSize = delta.size();
+        size_t pos = 0;
+        size_t i = 0;
+        while (pos + 4 <= inSize) {
+            uint16_t zeros, literals;
+            std::memcpy(&zeros, in + pos, 2);
+            std::memcpy(&literals, in + pos + 2, 2);
+            pos += 4;
+
+            i += zeros;
+            if (i + literals > sizeof(RawState) || pos + literals > inSize) return std::nullopt;
+            for (uint16_t j = 0; j < literals; ++j) {
+                out[i++] ^= in[pos++];
+            }
+        }
+        if (pos != inSize || i > sizeof(RawState)) return std::nullopt;
+        return state;
+    }
+}
+
+SaveStateManager& SaveStateManager::instance()
+{
+    static SaveStateManager s_instance;
+    return s_instance;
+}
+
+bool SaveStateManager::capture(int slot, std::function<void(bool captured)> callback)
+{
+    if (slot < 0 || slot >= SLOT_COUNT) return false;
+
+    try {
+        LunarTear::Get().QueuePhaseUpdateCallback([this, slot, callback = std::move(callback)]() {
+            auto state = captureRaw();
+            if (state) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_baseline.isEmpty()) {
+                    m_baseline = QByteArray(reinterpret_cast<const char*>(&*state), sizeof(RawState));
+                }
+
+                Slot& target = m_slots[slot];
+                target.delta = encodeDelta(*state, m_baseline);
+                target.info.used = true;
+                target.info.phase = phaseOf(*state);
+                target.info.created = QDateTime::currentDateTime();
+                target.info.encodedSize = target.delta.size();
+            }
+            if (callback) callback(state.has_value());
+        });
+    }
+    catch (const LunarTearUninitializedError& e) {
+        return false;
+    }
+    return true;
+}
+
+bool SaveStateManager::restore(int slot)
+{
+    if (slot < 0 || slot >= SLOT_COUNT) return false;
+
+    std::optional<RawState> state;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_slots[slot].info.used) return false;
+        state = decodeDelta(m_slots[slot].delta, m_baseline);
+    }
+    if (!state) return false;
+
+    RawState raw = *state;
+    QString phase = phaseOf(raw);
+    if (phase != GameData::instance().getCurrentPhase()) {
+        LunarTear::Get().QueuePhaseScriptExecution(QString("_ChangeMap('%1', 0)").arg(phase).toStdString());
+        enqueuePostStartTask([raw]() { applyRaw(raw); });
+    }
+    else {
+        LunarTear::Get().QueuePhaseUpdateCallback([raw]() { applyRaw(raw); });
+    }
+    return true;
+}
+
+void SaveStateManager::clear(int slot)
+{
+    if (slot < 0 || slot >= SLOT_COUNT) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots[slot] = Slot();
+}
+
+SaveStateInfo SaveStateManager::slotInfo(int slot) const
+{
+    if (slot < 0 || slot >= SLOT_COUNT) return {};
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_slots[slot].info;
+}
+
+bool SaveStateManager::save(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(FILE_MAGIC, sizeof(FILE_MAGIC));
+    stream << FILE_VERSION << quint32(sizeof(RawState));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stream << m_baseline << quint32(SLOT_COUNT);
+    for (const Slot& slot : m_slots) {
+        stream << slot.info.used;
+        if (!slot.info.used) continue;
+        stream << slot.info.created << slot.delta;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool SaveStateManager::load(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[4];
+    quint32 version = 0, stateSize = 0, slotCount = 0;
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    stream >> version >> stateSize;
+    // The raw layout follows the game structs, a different size means a different build
+    if (version != FILE_VERSION || stateSize != sizeof(RawState)) {
+        return false;
+    }
+
+    QByteArray baseline;
+    stream >> baseline >> slotCount;
+    if (baseline.size() != sizeof(RawState)) return false;
+
+    Slot slots[SLOT_COUNT];
+    for (quint32 i = 0; i < slotCount; ++i) {
+        Slot slot;
+        stream >> slot.info.used;
+        if (slot.info.used) {
+            stream >> slot.info.created >> slot.delta;
+            auto state = decodeDelta(slot.delta, baseline);
+            if (!state) return false;
+            slot.info.phase = phaseOf(*state);
+            slot.info.encodedSize = slot.delta.size();
+        }
+        if (i < SLOT_COUNT) slots[i] = std::move(slot);
+    }
+    if (stream.status() != QDataStream::Ok) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_baseline = baseline;
+    for (int i = 0; i < SLOT_COUNT; ++i) m_slots[i] = std::move(slots[i]);
+    return true;
+}
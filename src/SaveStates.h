@@ -0,0 +1,58 @@
+#pragma once
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+struct SaveStateInfo {
+    bool used = false;
+    QString phase;
+    QDateTime created;
+    int encodedSize = 0;
+};
+
+// Quick save/restore of the player's state: PlayerSaveData (which carries inventory
+// and weapon levels), the CPlayerParam stats, position and rotation.
+//
+// States are stored as the XOR delta against a baseline captured with the first
+// state, then zero run-length encoded, so slots cost a few hundred bytes. Slots
+// persist to disk in a versioned "LTSS" file.
+class SaveStateManager
+{
+public:
+    static constexpr int SLOT_COUNT = 10;
+
+    static SaveStateManager& instance();
+
+    // Reads the state on the game thread, then calls back there with whether the slot was filled.
+    // False if nothing was queued
+    bool capture(int slot, std::function<void(bool captured)> callback = nullptr);
+
+    // Writes the slot back on the game thread. Changes map first if it was taken elsewhere
+    bool restore(int slot);
+
+    void clear(int slot);
+
+    SaveStateInfo slotInfo(int slot) const;
+
+    bool load(const QString& filePath);
+    bool save(const QString& filePath) const;
+
+private:
+    SaveStateManager() = default;
+    ~SaveStateManager() = default;
+    SaveStateManager(const SaveStateManager&) = delete;
+    SaveStateManager& operator=(const SaveStateManager&) = delete;
+
+    struct Slot {
+        SaveStateInfo info;
+        QByteArray delta;
+    };
+
+    mutable std::mutex m_mutex;
+    QByteArray m_baseline;
+    Slot m_slots[SLOT_COUNT];
+};
@@ -0,0 +1,174 @@
+#include "ScriptBatch.h"
+#include <LunarTear++.h>
+#include <QHash>
+#include <mutex>
+
+namespace {
+    // Generated Lua source per template, escaped and ready to embed
+    std::mutex g_templateCacheMutex;
+    QHash<QString, QString> g_templateCache;
+
+    QString formatNumber(double value) {
+        return QString::number(value, 'g', 17);
+    }
+
+    // Returned by the data-only script when the dispatcher global isn't there
+    constexpr int STATUS_MISSING_TEMPLATE = -2;
+
+    QString quoteLuaString(const QString& source) {
+        QString quoted = source;
+        quoted.replace("\\", "\\\\");
+        quoted.replace("\"", "\\\"");
+        quoted.replace("\n", "\\n");
+        return "\"" + quoted + "\"";
+    }
+}
+
+ScriptBatch& ScriptBatch::call(const QString& function, std::initializer_list<double> args)
+{
+    int arity = static_cast<int>(args.size());
+    int opcode = -1;
+    for (size_t i = 0; i < m_functions.size(); ++i) {
+        if (m_functions[i].name == function && m_functions[i].arity == arity) {
+            opcode = static_cast<int>(i) + 1;
+            break;
+        }
+    }
+    if (opcode == -1) {
+        m_functions.push_back({ function, arity });
+        opcode = static_cast<int>(m_functions.size());
+    }
+
+    m_data.push_back(opcode);
+    m_data.insert(m_data.end(), args.begin(), args.end());
+    ++m_operationCount;
+    return *this;
+}
+
+void ScriptBatch::clear()
+{
+    m_functions.clear();
+    m_data.clear();
+    m_operationCount = 0;
+}
+
+QString ScriptBatch::templateKey() const
+{
+    QStringList parts;
+    for (const auto& fn : m_functions) {
+        parts << QString("%1/%2").arg(fn.name).arg(fn.arity);
+    }
+    return parts.join(';');
+}
+
+QString ScriptBatch::compileTemplate() const
+{
+    // Lua in the phase state has no base library, so pcall and getn come from our own registrations
+    QString source = "return function(d)\n"
+        "local n = _ifaifa_LTCon_table_getn(d)\n"
+        "local i = 1\n"
+        "local failed = 0\n"
+        "while i <= n do\n"
+        "local op = d[i]\n"
+        "local ok = true\n";
+
+    for (size_t f = 0; f < m_functions.size(); ++f) {
+        const auto& fn = m_functions[f];
+        QStringList args = { fn.name };
+        for (int a = 1; a <= fn.arity; ++a) {
+            args << QString("d[i + %1]").arg(a);
+        }
+        source += QString("%1 op == %2 then ok = _ifaifa_LTCon_pcall(%3) i = i + %4\n")
+            .arg(f == 0 ? "if" : "elseif")
+            .arg(f + 1)
+            .arg(args.join(", "))
+            .arg(fn.arity + 1);
+    }
+
+    source += "else return -1 end\n"
+        "if not ok then failed = failed + 1 end\n"
+        "end\n"
+        "return failed\n"
+        "end\n";
+    return source;
+}
+
+QString ScriptBatch::functionName() const
+{
+    return QString("ifaifa_LTCon_batch_%1").arg(qHash(templateKey()), 0, 16);
+}
+
+QString ScriptBatch::script(bool withSource) const
+{
+    QStringList values;
+    values.reserve(static_cast<qsizetype>(m_data.size()));
+    for (double value : m_data) {
+        values << formatNumber(value);
+    }
+
+    const QString name = functionName();
+    if (!withSource) {
+        return QString("if not %1 then return %2 end\n"
+            "return %1({%3})")
+            .arg(name).arg(STATUS_MISSING_TEMPLATE).arg(values.join(','));
+    }
+
+    QString quotedSource;
+    {
+        std::lock_guard<std::mutex> lock(g_templateCacheMutex);
+        const QString key = templateKey();
+        auto it = g_templateCache.constFind(key);
+        if (it == g_templateCache.constEnd()) {
+            it = g_templateCache.insert(key, quoteLuaString(compileTemplate()));
+        }
+        quotedSource = it.value();
+    }
+
+    // Phase changes reset the Lua globals, so the compiled function is recreated on demand
+    return QString("%1 = _ifaifa_LTCon_loadstring(%2)()\n"
+        "return %1({%3})")
+        .arg(name, quotedSource, values.join(','));
+}
+
+void ScriptBatch::run(Callback callback) const
+{
+    if (isEmpty()) return;
+
+    const int operations = m_operationCount;
+    auto report = [callback, operations](const LuaResult& luaResult) {
+        BatchResult result;
+        result.operations = operations;
+        if (luaResult.IsError()) {
+            result.scriptError = true;
+            result.message = QString::fromStdString(luaResult.AsString());
+        }
+        else {
+            int failed = static_cast<int>(luaResult.AsInteger(0));
+            if (failed < 0) {
+                result.scriptError = true;
+                result.message = "Batch data did not match its template";
+            }
+            else {
+                result.failed = failed;
+            }
+        }
+
+        if (callback) {
+            callback(result);
+        }
+        else if (!result.ok()) {
+            LunarTear::Get().Log(LT_LOG_WARNING) << "ScriptBatch: " << result.failed << " of " << result.operations
+                << " calls failed " << result.message.toStdString();
+        }
+    };
+
+    // Most runs find the dispatcher from an earlier batch, only the first after a phase change sends the source
+    std::string withSource = script(true).toStdString();
+    LunarTear::Get().QueuePhaseScriptExecution(script().toStdString(), [report, withSource](const LuaResult& luaResult) {
+        if (!luaResult.IsError() && luaResult.AsInteger(0) == STATUS_MISSING_TEMPLATE) {
+            LunarTear::Get().QueuePhaseScriptExecution(withSource, report);
+            return;
+        }
+        report(luaResult);
+    });
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+
+struct BatchResult {
+    int operations = 0;
+    int failed = 0;
+    bool scriptError = false;
+    QString message;
+
+    bool ok() const { return !scriptError && failed == 0; }
+};
+
+// Collects many game script calls and runs them as one phase script execution.
+//
+// The calls are split into a template, the distinct functions and their arities in
+// first-use order, and a flat list of numeric arguments. Each template is compiled
+// once into a Lua function kept in a global. A batch first ships only its data and
+// sends the template's source again only when that global is gone, e.g. after a
+// phase change. Meant for bulk work; a single call is cheaper as a plain script.
+class ScriptBatch
+{
+public:
+    using Callback = std::function<void(const BatchResult&)>;
+
+    ScriptBatch& call(const QString& function, std::initializer_list<double> args);
+
+    ScriptBatch& addItemNum(int itemId, int count) { return call("_AddItemNum", { double(itemId), double(count) }); }
+    ScriptBatch& setUniqueActorInvincible(int actorId, int value) { return call("_SetUniqueActorInvincible", { double(actorId), double(value) }); }
+    ScriptBatch& setUniqueActorLevel(int actorId, int level) { return call("_SetUniqueActorLevel", { double(actorId), double(level) }); }
+    ScriptBatch& setGameSpeed(float factor) { return call("_SetGameSpeed", { factor }); }
+    ScriptBatch& setPlayerSpeed(float factor) { return call("_SetPlayerSpeed", { factor }); }
+
+    bool isEmpty() const { return m_operationCount == 0; }
+    int size() const { return m_operationCount; }
+    void clear();
+
+    // Queues the whole batch for the next phase update. The callback runs on the game thread,
+    // without one failures are logged
+    void run(Callback callback = nullptr) const;
+
+    // The script run() queues first, for inspection and logging. With source it also
+    // compiles the template, which is what gets sent when the dispatcher is missing
+    QString script(bool withSource = false) const;
+
+private:
+    struct Function {
+        QString name;
+        int arity;
+    };
+
+    QString templateKey() const;
+    QString compileTemplate() const;
+    QString functionName() const;
+
+    std::vector<Function> m_functions;
+    std::vector<double> m_data; // opcode, args..., opcode, args...
+    int m_operationCount = 0;
+};
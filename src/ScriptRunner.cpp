@@ -0,0 +1,254 @@
+#include "ScriptRunner.h"
+#include <LunarTear++.h>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <algorithm>
+
+namespace {
+    // First character of what the generated Lua returns
+    constexpr char STATUS_OK = 'o';
+    constexpr char STATUS_RUNTIME_ERROR = 'e';
+    constexpr char STATUS_COMPILE_ERROR = 'c';
+    constexpr char STATUS_MISSING = 'm';     // Compiled function gone, the phase state was reset
+    constexpr char STATUS_INTERRUPTED = 'i'; // Upload pieces gone, same reason
+
+    // Works on bytes, a piece may end halfway through a UTF-8 sequence and Lua strings don't care
+    std::string quoteLuaBytes(const QByteArray& bytes) {
+        std::string quoted;
+        quoted.reserve(bytes.size() + bytes.size() / 8 + 2);
+        quoted += '"';
+        for (char c : bytes) {
+            switch (c) {
+            case '\\': quoted += "\\\\"; break;
+            case '"': quoted += "\\\""; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\0': quoted += "\\000"; break;
+            default: quoted += c; break;
+            }
+        }
+        quoted += '"';
+        return quoted;
+    }
+
+    // Runs the compiled function, appended to both the upload's last piece and plain calls
+    QString callSource(const QString& function) {
+        return QString("local f = %1\n"
+            "if not f then return \"%2\" end\n"
+            "local ok, r = _ifaifa_LTCon_pcall(f)\n"
+            "if not ok then return \"%3\" .. _ifaifa_LTCon_tostring(r) end\n"
+            "if r == nil then return \"%4\" end\n"
+            "return \"%4\" .. _ifaifa_LTCon_tostring(r)\n")
+            .arg(function, QString(QChar(STATUS_MISSING)), QString(QChar(STATUS_RUNTIME_ERROR)), QString(QChar(STATUS_OK)));
+    }
+
+    ScriptRunResult parseResult(const LuaResult& luaResult, bool compiled, int chunks) {
+        ScriptRunResult result;
+        result.compiled = compiled;
+        result.chunks = chunks;
+
+        const QString text = QString::fromStdString(luaResult.AsString());
+        if (luaResult.IsError()) {
+            result.output = text;
+            return result;
+        }
+
+        const QChar status = text.isEmpty() ? QChar() : text[0];
+        result.output = text.mid(1);
+        result.ok = status == STATUS_OK;
+        if (status == STATUS_INTERRUPTED) {
+            result.output = "Upload interrupted by a phase change, run it again";
+        }
+        else if (status == STATUS_COMPILE_ERROR) {
+            result.output = "Compile error: " + result.output;
+        }
+        return result;
+    }
+}
+
+ScriptRunner& ScriptRunner::instance()
+{
+    static ScriptRunner s_instance;
+    return s_instance;
+}
+
+QString ScriptRunner::scriptDirectory() const
+{
+    try {
+        return QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon")) + "/scripts";
+    }
+    catch (const LunarTearUninitializedError& e) {
+        return QString();
+    }
+}
+
+QStringList ScriptRunner::availableScripts() const
+{
+    const QString directory = scriptDirectory();
+    if (directory.isEmpty()) return QStringList();
+    return QDir(directory).entryList({ "*.lua" }, QDir::Files, QDir::Name);
+}
+
+QString ScriptRunner::compiledName(const QString& hash)
+{
+    return "ifaifa_LTCon_script_" + hash;
+}
+
+QString ScriptRunner::uploadName(const QString& hash)
+{
+    return "ifaifa_LTCon_upload_" + hash;
+}
+
+bool ScriptRunner::readScript(const QString& path, ScriptFile* script, QString* error)
+{
+    const QFileInfo info(path);
+    const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_files.constFind(path);
+        if (it != m_files.constEnd() && it->lastModified == lastModified && it->size == info.size()) {
+            *script = it.value();
+            return true;
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("Could not open %1").arg(path);
+        return false;
+    }
+    const QByteArray content = file.readAll();
+
+    script->lastModified = lastModified;
+    script->size = content.size();
+    script->source = content;
+    script->hash = QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex().left(16));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.insert(path, *script);
+    return true;
+}
+
+bool ScriptRunner::run(const QString& name, Callback callback, QString* error)
+{
+    const QString directory = scriptDirectory();
+    if (directory.isEmpty()) {
+        if (error) *error = "Scripts need the game to be running";
+        return false;
+    }
+
+    const QString fileName = name.endsWith(".lua") ? name : name + ".lua";
+    const QFileInfo info(QDir(directory).absoluteFilePath(fileName));
+    if (!info.isFile()) {
+        if (error) *error = QString("No script %1 in %2").arg(fileName, directory);
+        return false;
+    }
+    // Names like ../foo.lua would reach outside the scripts directory
+    if (!info.canonicalFilePath().startsWith(QDir(directory).canonicalPath() + '/')) {
+        if (error) *error = QString("%1 is outside %2").arg(fileName, directory);
+        return false;
+    }
+
+    const QString path = info.canonicalFilePath();
+    ScriptFile script;
+    if (!readScript(path, &script, error)) return false;
+
+    bool compiled = false;
+    QString staleHash;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        compiled = m_compiled.contains(script.hash);
+        staleHash = m_loadedHash.value(path);
+        if (staleHash == script.hash) staleHash.clear();
+    }
+
+    if (compiled) {
+        call(path, script, std::move(callback));
+    }
+    else {
+        upload(path, script, staleHash, std::move(callback));
+    }
+    return true;
+}
+
+void ScriptRunner::call(const QString& path, const ScriptFile& script, Callback callback)
+{
+    const std::string source = callSource(compiledName(script.hash)).toStdString();
+    LunarTear::Get().QueuePhaseScriptExecution(source, [this, path, script, callback](const LuaResult& luaResult) {
+        if (!luaResult.IsError() && luaResult.AsString().rfind(STATUS_MISSING, 0) == 0) {
+            // Reset since it was compiled, without a phase load being reported yet
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_compiled.remove(script.hash);
+            }
+            upload(path, script, QString(), callback);
+            return;
+        }
+        if (callback) callback(parseResult(luaResult, false, 0));
+    });
+}
+
+void ScriptRunner::upload(const QString& path, const ScriptFile& script, const QString& staleHash, Callback callback)
+{
+    const QByteArray& bytes = script.source;
+    const QString table = uploadName(script.hash);
+    const int chunks = std::max(1, int((bytes.size() + CHUNK_SIZE - 1) / CHUNK_SIZE));
+
+    const QString interrupted(QChar(STATUS_INTERRUPTED));
+
+    for (int i = 0; i < chunks; ++i) {
+        // Later pieces check the table is still there before writing into it, a phase load in between drops it
+        QString head = i == 0
+            ? QString("local u = {}\n%1 = u\n").arg(table)
+            : QString("local u = %1\nif not u then return \"%2\" end\n").arg(table, interrupted);
+        std::string piece = head.toStdString();
+        piece += QString("u[%1] = ").arg(i + 1).toStdString();
+        piece += quoteLuaBytes(bytes.mid(qsizetype(i) * CHUNK_SIZE, CHUNK_SIZE));
+        piece += '\n';
+
+        if (i + 1 < chunks) {
+            LunarTear::Get().QueuePhaseScriptExecution(piece);
+            continue;
+        }
+
+        // The last piece joins, compiles, drops the function of the file's previous content and runs
+        QString finish = QString("%1 = nil\n"
+            "local s = \"\"\n"
+            "local i = 1\n"
+            "while u[i] do s = s .. u[i] i = i + 1 end\n"
+            "local c, e = _ifaifa_LTCon_loadstring(s, \"=%2\")\n"
+            "if not c then return \"%3\" .. _ifaifa_LTCon_tostring(e) end\n")
+            .arg(table, QFileInfo(path).fileName(), QString(QChar(STATUS_COMPILE_ERROR)));
+        if (!staleHash.isEmpty()) {
+            finish += compiledName(staleHash) + " = nil\n";
+        }
+        finish += compiledName(script.hash) + " = c\n";
+        finish += callSource(compiledName(script.hash));
+        piece += finish.toStdString();
+
+        LunarTear::Get().QueuePhaseScriptExecution(piece, [this, path, hash = script.hash, chunks, callback](const LuaResult& luaResult) {
+            ScriptRunResult result = parseResult(luaResult, true, chunks);
+            const std::string status = luaResult.AsString();
+            const bool compiledOk = !luaResult.IsError() && !status.empty() &&
+                status[0] != STATUS_INTERRUPTED && status[0] != STATUS_COMPILE_ERROR;
+            if (compiledOk) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const QString previous = m_loadedHash.value(path);
+                if (!previous.isEmpty() && previous != hash) m_compiled.remove(previous);
+                m_compiled.insert(hash);
+                m_loadedHash.insert(path, hash);
+            }
+            if (callback) callback(result);
+        });
+    }
+}
+
+void ScriptRunner::invalidatePhaseState()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_compiled.clear();
+    m_loadedHash.clear();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <functional>
+#include <mutex>
+
+struct ScriptRunResult {
+    bool ok = false;
+    bool compiled = false; // False when the function already cached in the Lua state was reused
+    int chunks = 0; // Uploads it took to get the source into the Lua state
+    QString output; // tostring of what the script returned, or the error
+};
+
+// Runs Lua files from the mod's scripts directory in the phase state.
+//
+// Each file is compiled once into a global named after the hash of its content,
+// so running it again only ships a short call. Sources are uploaded in pieces of
+// at most CHUNK_SIZE characters, one phase script execution each, and joined in
+// Lua before compiling. Phase loads reset the Lua globals, so the set of compiled
+// hashes is dropped then; a call that still finds its function gone uploads again.
+class ScriptRunner
+{
+public:
+    using Callback = std::function<void(const ScriptRunResult&)>;
+
+    static constexpr int CHUNK_SIZE = 16 * 1024;
+
+    static ScriptRunner& instance();
+
+    QString scriptDirectory() const;
+    QStringList availableScripts() const;
+
+    // Queues the script for the next phase updates. The callback runs on the game thread.
+    // Returns false, with the reason in error, if the file couldn't be read
+    bool run(const QString& name, Callback callback, QString* error = nullptr);
+
+    // Game thread, after a phase load threw away the compiled functions
+    void invalidatePhaseState();
+
+private:
+    ScriptRunner() = default;
+    ~ScriptRunner() = default;
+
+    ScriptRunner(const ScriptRunner&) = delete;
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+
+    struct ScriptFile {
+        qint64 lastModified = 0;
+        qint64 size = 0;
+        QByteArray source; // UTF-8, as read
+        QString hash; // Hex, part of the Lua global name
+    };
+
+    bool readScript(const QString& path, ScriptFile* script, QString* error);
+    void upload(const QString& path, const ScriptFile& script, const QString& staleHash, Callback callback);
+    void call(const QString& path, const ScriptFile& script, Callback callback);
+
+    static QString compiledName(const QString& hash);
+    static QString uploadName(const QString& hash);
+
+    mutable std::mutex m_mutex;
+    QHash<QString, ScriptFile> m_files; // By path, re-read only when size or timestamp change
+    QHash<QString, QString> m_loadedHash; // Path to the hash last compiled for it
+    QSet<QString> m_compiled; // Hashes compiled in the current phase state
+};
@@ -0,0 +1,252 @@
+#include "Trajectory.h"
+#include "GameData.h"
+#include <LunarTear++.h>
+#include <QFile>
+#include <QDataStream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    const char FILE_MAGIC[4] = { 'L', 'T', 'T', 'R' };
+    const quint16 FILE_VERSION = 1;
+
+    void writeVarint(QByteArray& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.append(char((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.append(char(value));
+    }
+
+    bool readVarint(const QByteArray& in, qsizetype& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= in.size()) return false;
+            uint8_t byte = static_cast<uint8_t>(in[pos++]);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Zig-zag so small negative deltas stay small
+    uint64_t zigzag(int64_t value) { return (uint64_t(value) << 1) ^ uint64_t(value >> 63); }
+    int64_t unzigzag(uint64_t value) { return int64_t(value >> 1) ^ -int64_t(value & 1); }
+}
+
+TrajectoryRecorder& TrajectoryRecorder::instance()
+{
+    static TrajectoryRecorder s_instance;
+    return s_instance;
+}
+
+void TrajectoryRecorder::setRecording(bool recording)
+{
+    if (m_recording.exchange(recording) == recording) return;
+
+    if (recording) {
+        m_frameCallbackId = registerFrameCallback([this](float deltaSeconds) { onFrame(deltaSeconds); });
+    }
+    else {
+        unregisterFrameCallback(m_frameCallbackId);
+        m_frameCallbackId = 0;
+    }
+}
+
+void TrajectoryRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ring.clear();
+    m_head = 0;
+    m_phases.clear();
+    m_lastPhase.clear();
+    m_lastPhaseIndex = 0;
+    m_time = 0.0;
+    ++m_revision;
+}
+
+size_t TrajectoryRecorder::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ring.size();
+}
+
+uint16_t TrajectoryRecorder::phaseIndex(const char* phase, size_t length)
+{
+    if (!m_lastPhase.empty() && m_lastPhase.size() == length && std::memcmp(m_lastPhase.data(), phase, length) == 0) {
+        return m_lastPhaseIndex;
+    }
+
+    m_lastPhase.assign(phase, length);
+    QString name = QString::fromUtf8(phase, static_cast<qsizetype>(length));
+    qsizetype index = m_phases.indexOf(name);
+    if (index < 0) {
+        m_phases.append(name);
+        index = m_phases.size() - 1;
+    }
+    m_lastPhaseIndex = static_cast<uint16_t>(index);
+    return m_lastPhaseIndex;
+}
+
+void TrajectoryRecorder::push(const TrajectoryPoint& point)
+{
+    if (m_ring.size() < CAPACITY) {
+        if (m_ring.capacity() < CAPACITY) m_ring.reserve(CAPACITY);
+        m_ring.push_back(point);
+        return;
+    }
+    m_ring[m_head] = point;
+    m_head = (m_head + 1) % CAPACITY;
+}
+
+void TrajectoryRecorder::onFrame(float deltaSeconds)
+{
+    if (!m_recording.load() || !GameData::instance().isGameActive()) {
+        return;
+    }
+
+    PlayerSaveData* saveData = LunarTear::Get().Game().GetPlayerSaveData();
+    ActorPlayable* actor = LunarTear::Get().Game().GetActorPlayable();
+    if (!saveData || !actor) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_time += deltaSeconds;
+
+    uint16_t phase = phaseIndex(saveData->current_phase, strnlen(saveData->current_phase, sizeof(saveData->current_phase)));
+    TrajectoryPoint point{ static_cast<float>(m_time), actor->posX, actor->posY, actor->posZ, phase };
+
+    if (!m_ring.empty()) {
+        const TrajectoryPoint& last = m_ring[(m_head + m_ring.size() - 1) % m_ring.size()];
+        float dx = point.x - last.x, dy = point.y - last.y, dz = point.z - last.z;
+        if (last.phase == phase && dx * dx + dy * dy + dz * dz < MIN_STEP * MIN_STEP) {
+            return;
+        }
+    }
+
+    push(point);
+    ++m_revision;
+}
+
+std::vector<TrajectoryPoint> TrajectoryRecorder::ordered() const
+{
+    std::vector<TrajectoryPoint> result;
+    result.reserve(m_ring.size());
+    result.insert(result.end(), m_ring.begin() + m_head, m_ring.end());
+    result.insert(result.end(), m_ring.begin(), m_ring.begin() + m_head);
+    return result;
+}
+
+std::vector<QVector3D> TrajectoryRecorder::pointsInPhase(const QString& phase) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<QVector3D> result;
+
+    qsizetype index = m_phases.indexOf(phase);
+    if (index < 0) return result;
+
+    const size_t count = m_ring.size();
+    for (size_t i = 0; i < count; ++i) {
+        const TrajectoryPoint& point = m_ring[(m_head + i) % count];
+        if (point.phase == index) {
+            result.emplace_back(point.x, point.y, point.z);
+        }
+    }
+    return result;
+}
+
+bool TrajectoryRecorder::exportToFile(const QString& filePath) const
+{
+    std::vector<TrajectoryPoint> points;
+    QStringList phases;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        points = ordered();
+        phases = m_phases;
+    }
+
+    QByteArray payload;
+    payload.reserve(static_cast<qsizetype>(points.size()) * 8);
+    int64_t lastTime = 0, lastX = 0, lastY = 0, lastZ = 0;
+    uint16_t lastPhase = 0;
+    for (const TrajectoryPoint& point : points) {
+        int64_t time = std::llround(point.time * 1000.0);
+        int64_t x = std::llround(point.x / QUANTUM);
+        int64_t y = std::llround(point.y / QUANTUM);
+        int64_t z = std::llround(point.z / QUANTUM);
+
+        writeVarint(payload, zigzag(int64_t(point.phase) - lastPhase));
+        writeVarint(payload, zigzag(time - lastTime));
+        writeVarint(payload, zigzag(x - lastX));
+        writeVarint(payload, zigzag(y - lastY));
+        writeVarint(payload, zigzag(z - lastZ));
+
+        lastPhase = point.phase;
+        lastTime = time;
+        lastX = x; lastY = y; lastZ = z;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(FILE_MAGIC, sizeof(FILE_MAGIC));
+    stream << FILE_VERSION << phases << quint32(points.size()) << payload;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool TrajectoryRecorder::importFromFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[4];
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    quint16 version = 0;
+    QStringList phases;
+    quint32 count = 0;
+    QByteArray payload;
+    stream >> version >> phases >> count >> payload;
+    if (stream.status() != QDataStream::Ok || version != FILE_VERSION) return false;
+
+    std::vector<TrajectoryPoint> points;
+    points.reserve(std::min<size_t>(count, CAPACITY));
+    qsizetype pos = 0;
+    int64_t phase = 0, time = 0, x = 0, y = 0, z = 0;
+    for (quint32 i = 0; i < count; ++i) {
+        uint64_t dp, dt, dx, dy, dz;
+        if (!readVarint(payload, pos, dp) || !readVarint(payload, pos, dt) ||
+            !readVarint(payload, pos, dx) || !readVarint(payload, pos, dy) || !readVarint(payload, pos, dz)) {
+            return false;
+        }
+        phase += unzigzag(dp);
+        time += unzigzag(dt);
+        x += unzigzag(dx);
+        y += unzigzag(dy);
+        z += unzigzag(dz);
+        if (phase < 0 || phase >= phases.size()) return false;
+
+        points.push_back(TrajectoryPoint{ time / 1000.0f, x * QUANTUM, y * QUANTUM, z * QUANTUM, static_cast<uint16_t>(phase) });
+    }
+
+    // Only the newest CAPACITY points fit in the ring
+    if (points.size() > CAPACITY) {
+        points.erase(points.begin(), points.end() - CAPACITY);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ring = std::move(points);
+    m_head = 0;
+    m_phases = phases;
+    m_lastPhase.clear();
+    m_time = m_ring.empty() ? 0.0 : m_ring.back().time;
+    ++m_revision;
+    return true;
+}
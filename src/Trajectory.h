@@ -0,0 +1,68 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector3D>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "Callbacks.h"
+
+struct TrajectoryPoint {
+    float time;         // Seconds since recording started
+    float x, y, z;
+    uint16_t phase;     // Index into TrajectoryRecorder::phases()
+};
+
+// Samples the player position once per game frame into a fixed-size ring, so a
+// long session costs the same memory as a short one. Frames where the player
+// hasn't moved are skipped to stretch the window further back.
+class TrajectoryRecorder
+{
+public:
+    static constexpr size_t CAPACITY = 65536;
+    static constexpr float MIN_STEP = 0.05f;
+
+    static TrajectoryRecorder& instance();
+
+    void setRecording(bool recording);
+    bool isRecording() const { return m_recording.load(); }
+    void clear();
+
+    // Bumped on every change, lets the UI skip re-fetching an unchanged trail
+    uint64_t revision() const { return m_revision.load(); }
+    size_t size() const;
+
+    // Positions recorded in the given phase, oldest first
+    std::vector<QVector3D> pointsInPhase(const QString& phase) const;
+
+    // Binary export: phase table, then each point as varint time and position
+    // deltas against the previous point, quantized to QUANTUM units
+    bool exportToFile(const QString& filePath) const;
+    bool importFromFile(const QString& filePath);
+
+private:
+    TrajectoryRecorder() = default;
+    ~TrajectoryRecorder() = default;
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    static constexpr float QUANTUM = 0.01f;
+
+    void onFrame(float deltaSeconds);
+    uint16_t phaseIndex(const char* phase, size_t length);
+    void push(const TrajectoryPoint& point);
+    std::vector<TrajectoryPoint> ordered() const;
+
+    mutable std::mutex m_mutex;
+    std::vector<TrajectoryPoint> m_ring;
+    size_t m_head = 0;
+    QStringList m_phases;
+    std::string m_lastPhase;
+    uint16_t m_lastPhaseIndex = 0;
+    double m_time = 0.0;
+
+    std::atomic<bool> m_recording = false;
+    std::atomic<uint64_t> m_revision = 0;
+    CallbackId m_frameCallbackId = 0;
+};
@@ -0,0 +1,292 @@
+#include "Watches.h"
+#include <LunarTear++.h>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    struct KnownField {
+        const char* name;
+        WatchBase base;
+        size_t offset;
+        WatchType type;
+    };
+
+    const KnownField knownFields[] = {
+        { "save.current_hp", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, current_hp), WatchType::Int32 },
+        { "save.current_mp", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, current_mp), WatchType::Float },
+        { "save.current_level", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, current_level), WatchType::Int32 },
+        { "save.current_xp", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, current_xp), WatchType::Int32 },
+        { "save.gold", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, gold), WatchType::Int32 },
+        { "save.currentWeapon", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, currentWeapon), WatchType::Int32 },
+        { "save.total_play_time", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, total_play_time), WatchType::Double },
+        { "save.kaine_player_current_hp", WatchBase::PlayerSaveData, offsetof(PlayerSaveData, kaine_player_current_hp), WatchType::Int32 },
+        { "param.maxHP", WatchBase::PlayerParam, offsetof(CPlayerParam, maxHP), WatchType::Int32 },
+        { "param.maxMP", WatchBase::PlayerParam, offsetof(CPlayerParam, maxMP), WatchType::Float },
+        { "param.attack_stat", WatchBase::PlayerParam, offsetof(CPlayerParam, attack_stat), WatchType::Int32 },
+        { "param.magickAttack_stat", WatchBase::PlayerParam, offsetof(CPlayerParam, magickAttack_stat), WatchType::Int32 },
+        { "param.defense_stat", WatchBase::PlayerParam, offsetof(CPlayerParam, defense_stat), WatchType::Int32 },
+        { "param.magickDefense_stat", WatchBase::PlayerParam, offsetof(CPlayerParam, magickDefense_stat), WatchType::Int32 },
+        { "player.posX", WatchBase::ActorPlayable, offsetof(ActorPlayable, posX), WatchType::Float },
+        { "player.posY", WatchBase::ActorPlayable, offsetof(ActorPlayable, posY), WatchType::Float },
+        { "player.posZ", WatchBase::ActorPlayable, offsetof(ActorPlayable, posZ), WatchType::Float },
+    };
+
+    size_t typeSize(WatchType type) {
+        switch (type) {
+        case WatchType::Int8: case WatchType::UInt8: return 1;
+        case WatchType::Int32: case WatchType::UInt32: case WatchType::Float: return 4;
+        case WatchType::Int64: case WatchType::Double: return 8;
+        }
+        return 4;
+    }
+
+    std::optional<WatchType> parseType(const QString& text) {
+        static const std::pair<const char*, WatchType> names[] = {
+            { "i8", WatchType::Int8 }, { "u8", WatchType::UInt8 },
+            { "i32", WatchType::Int32 }, { "u32", WatchType::UInt32 },
+            { "i64", WatchType::Int64 }, { "f32", WatchType::Float }, { "f64", WatchType::Double }
+        };
+        for (const auto& [name, type] : names) {
+            if (text.compare(name, Qt::CaseInsensitive) == 0) return type;
+        }
+        return std::nullopt;
+    }
+
+    double decode(const uint8_t* bytes, WatchType type) {
+        switch (type) {
+        case WatchType::Int8: { int8_t v; std::memcpy(&v, bytes, 1); return v; }
+        case WatchType::UInt8: return bytes[0];
+        case WatchType::Int32: { int32_t v; std::memcpy(&v, bytes, 4); return v; }
+        case WatchType::UInt32: { uint32_t v; std::memcpy(&v, bytes, 4); return v; }
+        case WatchType::Int64: { int64_t v; std::memcpy(&v, bytes, 8); return static_cast<double>(v); }
+        case WatchType::Float: { float v; std::memcpy(&v, bytes, 4); return v; }
+        case WatchType::Double: { double v; std::memcpy(&v, bytes, 8); return v; }
+        }
+        return 0.0;
+    }
+}
+
+QStringList knownWatchFields()
+{
+    QStringList fields;
+    for (const auto& field : knownFields) fields << field.name;
+    return fields;
+}
+
+std::optional<WatchDefinition> watchDefinitionForField(const QString& field)
+{
+    for (const auto& known : knownFields) {
+        if (field == known.name) {
+            return WatchDefinition{ field, known.base, known.offset, known.type };
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<WatchDefinition> parseWatchSpec(const QString& spec)
+{
+    QString trimmed = spec.trimmed();
+    if (auto known = watchDefinitionForField(trimmed)) return known;
+
+    QStringList parts = trimmed.split(':');
+    if (parts.isEmpty() || parts.size() > 2) return std::nullopt;
+
+    bool ok = false;
+    uintptr_t address = parts[0].toULongLong(&ok, 16);
+    if (!ok || address == 0) return std::nullopt;
+
+    WatchDefinition definition;
+    definition.name = trimmed;
+    definition.base = WatchBase::Absolute;
+    definition.offset = address;
+    if (parts.size() == 2) {
+        auto type = parseType(parts[1]);
+        if (!type) return std::nullopt;
+        definition.type = *type;
+    }
+    return definition;
+}
+
+WatchManager& WatchManager::instance()
+{
+    static WatchManager s_instance;
+    return s_instance;
+}
+
+WatchId WatchManager::addWatch(const WatchDefinition& definition)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Watch watch;
+    watch.id = m_nextId++;
+    watch.definition = definition;
+    watch.ring.reserve(SAMPLE_CAPACITY);
+    watch.stats.id = watch.id;
+    watch.stats.name = definition.name;
+    m_watches.push_back(std::move(watch));
+
+    if (m_frameCallbackId == 0) {
+        m_frameCallbackId = registerFrameCallback([this](float deltaSeconds) { onFrame(deltaSeconds); });
+    }
+    return m_watches.back().id;
+}
+
+void WatchManager::removeWatch(WatchId id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::erase_if(m_watches, [id](const Watch& watch) { return watch.id == id; });
+
+    if (m_watches.empty() && m_frameCallbackId != 0) {
+        unregisterFrameCallback(m_frameCallbackId);
+        m_frameCallbackId = 0;
+    }
+}
+
+void WatchManager::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_watches.clear();
+    m_events.clear();
+    if (m_frameCallbackId != 0) {
+        unregisterFrameCallback(m_frameCallbackId);
+        m_frameCallbackId = 0;
+    }
+}
+
+std::optional<double> WatchManager::read(const WatchDefinition& definition)
+{
+    const size_t size = typeSize(definition.type);
+    uint8_t bytes[8];
+
+    uintptr_t base = 0;
+    switch (definition.base) {
+    case WatchBase::PlayerSaveData: base = reinterpret_cast<uintptr_t>(LunarTear::Get().Game().GetPlayerSaveData()); break;
+    case WatchBase::PlayerParam: base = reinterpret_cast<uintptr_t>(LunarTear::Get().Game().GetPlayerParam()); break;
+    case WatchBase::ActorPlayable: base = reinterpret_cast<uintptr_t>(LunarTear::Get().Game().GetActorPlayable()); break;
+    case WatchBase::Absolute: {
+        // User supplied addresses may be unmapped, so they go through ReadProcessMemory instead of a raw load
+        SIZE_T read = 0;
+        if (!ReadProcessMemory(GetCurrentProcess(), reinterpret_cast<LPCVOID>(definition.offset), bytes, size, &read) || read != size) {
+            return std::nullopt;
+        }
+        return decode(bytes, definition.type);
+    }
+    }
+
+    if (!base) return std::nullopt;
+    std::memcpy(bytes, reinterpret_cast<const void*>(base + definition.offset), size);
+    return decode(bytes, definition.type);
+}
+
+void WatchManager::onFrame(float deltaSeconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_frame;
+    m_time += deltaSeconds;
+
+    for (auto& watch : m_watches) {
+        auto value = read(watch.definition);
+        WatchStats& stats = watch.stats;
+        stats.valid = value.has_value();
+        if (!value) continue;
+
+        // NaN compares unequal to itself, a float watch stuck on NaN isn't changing
+        const bool nan = std::isnan(*value);
+        if (stats.sampleCount > 0 && *value != stats.last && !(nan && std::isnan(stats.last))) {
+            ++stats.changeCount;
+            m_events.push_back({ m_nextEventSequence++, watch.id, m_frame, m_time, stats.last, *value });
+            if (m_events.size() > EVENT_CAPACITY) m_events.pop_front();
+        }
+
+        // The range only covers real values, it stays NaN until the first one
+        if (stats.sampleCount == 0 || std::isnan(stats.min)) {
+            stats.min = stats.max = *value;
+        }
+        else if (!nan) {
+            stats.min = std::min(stats.min, *value);
+            stats.max = std::max(stats.max, *value);
+        }
+        stats.last = *value;
+        ++stats.sampleCount;
+
+        WatchSample sample{ m_frame, m_time, *value };
+        if (watch.ring.size() < SAMPLE_CAPACITY) {
+            watch.ring.push_back(sample);
+        }
+        else {
+            watch.ring[watch.ringHead] = sample;
+            watch.ringHead = (watch.ringHead + 1) % SAMPLE_CAPACITY;
+        }
+    }
+}
+
+WatchStats WatchManager::computeStats(const Watch& watch)
+{
+    WatchStats stats = watch.stats;
+    if (watch.ring.size() < 2) return stats;
+
+    // Oldest sample sits at the head once the ring has wrapped
+    const WatchSample& oldest = watch.ring.size() < SAMPLE_CAPACITY ? watch.ring.front() : watch.ring[watch.ringHead];
+    const WatchSample& newest = watch.ring[(watch.ringHead + watch.ring.size() - 1) % watch.ring.size()];
+
+    double span = newest.time - oldest.time;
+    if (span <= 0.0) return stats;
+
+    size_t changes = 0;
+    for (size_t i = 1; i < watch.ring.size(); ++i) {
+        size_t cur = (watch.ringHead + i) % watch.ring.size();
+        size_t prev = (watch.ringHead + i - 1) % watch.ring.size();
+        if (watch.ring[cur].value != watch.ring[prev].value) ++changes;
+    }
+
+    stats.changesPerSecond = changes / span;
+    stats.valuePerSecond = (newest.value - oldest.value) / span;
+    return stats;
+}
+
+std::vector<WatchStats> WatchManager::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<WatchStats> result;
+    result.reserve(m_watches.size());
+    for (const auto& watch : m_watches) {
+        result.push_back(computeStats(watch));
+    }
+    return result;
+}
+
+std::optional<WatchStats> WatchManager::stats(WatchId id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& watch : m_watches) {
+        if (watch.id == id) return computeStats(watch);
+    }
+    return std::nullopt;
+}
+
+std::vector<WatchSample> WatchManager::samples(WatchId id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& watch : m_watches) {
+        if (watch.id != id) continue;
+        std::vector<WatchSample> ordered;
+        ordered.reserve(watch.ring.size());
+        for (size_t i = 0; i < watch.ring.size(); ++i) {
+            ordered.push_back(watch.ring[(watch.ringHead + i) % watch.ring.size()]);
+        }
+        return ordered;
+    }
+    return {};
+}
+
+std::vector<WatchEvent> WatchManager::eventsSince(uint64_t sequence) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<WatchEvent> result;
+    for (const auto& event : m_events) {
+        if (event.sequence > sequence) result.push_back(event);
+    }
+    return result;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+#include "Callbacks.h"
+
+enum class WatchType { Int8, UInt8, Int32, UInt32, Int64, Float, Double };
+
+// What the offset is relative to. Game structs are re-resolved every frame
+// since the player objects move between phases
+enum class WatchBase { Absolute, PlayerSaveData, PlayerParam, ActorPlayable };
+
+struct WatchDefinition {
+    QString name;
+    WatchBase base = WatchBase::Absolute;
+    uintptr_t offset = 0;
+    WatchType type = WatchType::Int32;
+};
+
+using WatchId = uint64_t;
+
+struct WatchSample {
+    uint64_t frame;
+    double time;
+    double value;
+};
+
+struct WatchStats {
+    WatchId id = 0;
+    QString name;
+    bool valid = false; // False while the base object doesn't exist
+    double last = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    uint64_t sampleCount = 0;
+    uint64_t changeCount = 0;
+    double changesPerSecond = 0.0; // Over the samples in the ring buffer
+    double valuePerSecond = 0.0;   // Net drift over the same window
+};
+
+struct WatchEvent {
+    uint64_t sequence;
+    WatchId id;
+    uint64_t frame;
+    double time;
+    double oldValue;
+    double newValue;
+};
+
+// Named fields of the game structs, e.g. "save.gold" or "param.maxHP"
+QStringList knownWatchFields();
+std::optional<WatchDefinition> watchDefinitionForField(const QString& field);
+
+// "save.gold", or an absolute address with an optional type: "0x7ff6a000:f32"
+std::optional<WatchDefinition> parseWatchSpec(const QString& spec);
+
+// Samples every watch once per game frame on the game thread. Each watch keeps a
+// ring of recent samples, and every value change is appended to a shared event
+// log that readers poll by sequence number.
+class WatchManager
+{
+public:
+    static constexpr size_t SAMPLE_CAPACITY = 600;
+    static constexpr size_t EVENT_CAPACITY = 2000;
+
+    static WatchManager& instance();
+
+    WatchId addWatch(const WatchDefinition& definition);
+    void removeWatch(WatchId id);
+    void clear();
+
+    std::vector<WatchStats> stats() const;
+    std::optional<WatchStats> stats(WatchId id) const;
+    std::vector<WatchSample> samples(WatchId id) const;
+
+    // Change events after the given sequence number, oldest first
+    std::vector<WatchEvent> eventsSince(uint64_t sequence) const;
+
+private:
+    WatchManager() = default;
+    ~WatchManager() = default;
+    WatchManager(const WatchManager&) = delete;
+    WatchManager& operator=(const WatchManager&) = delete;
+
+    struct Watch {
+        WatchId id;
+        WatchDefinition definition;
+        std::vector<WatchSample> ring;
+        size_t ringHead = 0;
+        WatchStats stats;
+    };
+
+    void onFrame(float deltaSeconds);
+    static std::optional<double> read(const WatchDefinition& definition);
+    static WatchStats computeStats(const Watch& watch);
+
+    mutable std::mutex m_mutex;
+    std::vector<Watch> m_watches;
+    std::deque<WatchEvent> m_events;
+    uint64_t m_nextEventSequence = 1;
+    WatchId m_nextId = 1;
+
+    uint64_t m_frame = 0;
+    double m_time = 0.0;
+    CallbackId m_frameCallbackId = 0;
+};
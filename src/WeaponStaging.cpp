@@ -0,0 +1,342 @@
+#include "WeaponStaging.h"
+#include "GameData.h"
+#include <LunarTear++.h>
+#include <cstring>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace {
+    using Body = replicant::raw::RawWeaponBody;
+
+    constexpr size_t ARENA_CHUNK_SIZE = 1024 * 1024;
+    constexpr size_t ARENA_CHUNK_BODIES = ARENA_CHUNK_SIZE / sizeof(Body);
+
+    // Whether the game reads the name offsets as int32 or uint32, a copy below its strings within this works for both
+    constexpr uintptr_t MAX_REACH = 0x7FFFFFFF;
+
+    std::byte* reserveBelow(const void* above, size_t size) {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        const uintptr_t granularity = info.dwAllocationGranularity;
+        const uintptr_t top = reinterpret_cast<uintptr_t>(above);
+        // Half the reach is left for the distance from the records to their strings
+        const uintptr_t lowest = top > MAX_REACH / 2 ? top - MAX_REACH / 2 : granularity;
+
+        uintptr_t address = top > size ? (top - size) & ~(granularity - 1) : 0;
+        while (address >= lowest) {
+            MEMORY_BASIC_INFORMATION region;
+            if (!VirtualQuery(reinterpret_cast<void*>(address), &region, sizeof(region))) break;
+
+            if (region.State == MEM_FREE) {
+                void* block = VirtualAlloc(reinterpret_cast<void*>(address), size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+                if (block) return static_cast<std::byte*>(block);
+                address -= granularity; // Free, but not enough of it from here
+                continue;
+            }
+
+            const uintptr_t base = reinterpret_cast<uintptr_t>(region.AllocationBase ? region.AllocationBase : region.BaseAddress);
+            if (base < lowest + size) break;
+            address = (base - size) & ~(granularity - 1);
+        }
+        return nullptr;
+#else
+        (void)above;
+        return static_cast<std::byte*>(std::malloc(size));
+#endif
+    }
+
+    // Fixed size blocks for staged records, in chunks reserved below the records
+    // as needed. The memory is never given back, the spec table may still point
+    // into it when the game shuts down. Only blocks that were never in the table
+    // come back through release
+    class BodyArena {
+    public:
+        Body* allocate(const Body* near) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free.empty()) {
+                std::byte* chunk = reserveBelow(near, ARENA_CHUNK_SIZE);
+                if (!chunk) return nullptr;
+                m_free.reserve(m_free.size() + ARENA_CHUNK_BODIES);
+                for (size_t i = ARENA_CHUNK_BODIES; i-- > 0;) {
+                    m_free.push_back(reinterpret_cast<Body*>(chunk + i * sizeof(Body)));
+                }
+            }
+
+            Body* body = m_free.back();
+            m_free.pop_back();
+            return body;
+        }
+
+        void release(Body* body) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(body);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<Body*> m_free;
+    };
+
+    BodyArena& arena() {
+        static BodyArena* s_arena = new BodyArena();
+        return *s_arena;
+    }
+
+    // Points the copy's offset field at the string the source's field points at.
+    // The source is only used for its address, its value comes from a snapshot
+    bool rebaseOffset(const uint32_t* fromField, uint32_t from, uint32_t& to) {
+        if (from == 0) {
+            to = 0;
+            return true;
+        }
+        const uintptr_t target = reinterpret_cast<uintptr_t>(fromField) + from;
+        const uintptr_t field = reinterpret_cast<uintptr_t>(&to);
+        if (target <= field || target - field > MAX_REACH) return false;
+        to = static_cast<uint32_t>(target - field);
+        return true;
+    }
+
+    // contents is what the record at source held when it was read
+    bool rebaseNames(const Body* source, const Body& contents, Body& copy) {
+        return rebaseOffset(&source->offestToJPName, contents.offestToJPName, copy.offestToJPName) &&
+            rebaseOffset(&source->offsetToInternalWeaponName, contents.offsetToInternalWeaponName, copy.offsetToInternalWeaponName);
+    }
+}
+
+WeaponStaging& WeaponStaging::instance()
+{
+    static WeaponStaging s_instance;
+    return s_instance;
+}
+
+WeaponStaging::WeaponStaging()
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+WeaponStaging::~WeaponStaging()
+{
+    m_pool.waitForDone();
+}
+
+WeaponStaging::Body* WeaponStaging::syncSlot(std::span<Body*> table, int slot)
+{
+    Body* current = table[slot];
+    const bool ours = current == m_originals[slot] || (m_installed[slot] && current == m_installed[slot].get());
+    if (!ours) {
+        // First look at the slot, or the game put a record of its own there since
+        m_originals[slot] = current;
+        retire(std::move(m_installed[slot]));
+        m_latest[slot].reset();
+    }
+    return m_originals[slot];
+}
+
+void WeaponStaging::retire(BodyPtr body)
+{
+    if (body) m_retired.push_back(std::move(body));
+}
+
+void WeaponStaging::schedule(Stage stage, Callback callback)
+{
+    try {
+        LunarTear::Get().QueuePhaseUpdateCallback([this, stage = std::move(stage), callback]() {
+            auto snapshot = std::make_shared<TableSnapshot>();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto table = GameData::instance().getWeaponSpecs();
+                if (table.data()) {
+                    for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+                        Body* original = syncSlot(table, slot);
+                        snapshot->originals[slot] = original;
+                        if (original) snapshot->bodies[slot] = *original;
+                    }
+                }
+            }
+            m_pool.start([stage, snapshot]() { stage(*snapshot); });
+        });
+    }
+    catch (const LunarTearUninitializedError& e) {
+        if (callback) callback(WeaponStageResult{ 0, 0, "Weapon records need the game to be running" });
+    }
+}
+
+WeaponStaging::BodyPtr WeaponStaging::stageCopy(const Body* near, QString* error)
+{
+    Body* block = arena().allocate(near);
+    if (!block) {
+        *error = "No staging memory within reach of the weapon records";
+        return nullptr;
+    }
+    return BodyPtr(block, [](Body* body) { arena().release(body); });
+}
+
+void WeaponStaging::editWeapon(int slot, std::function<void(Body&)> edit, Callback callback)
+{
+    if (slot < 0 || slot >= SLOT_COUNT) return;
+
+    schedule([this, slot, edit = std::move(edit), callback](const TableSnapshot& snapshot) {
+        WeaponStageResult result;
+        std::vector<StagedSlot> changes;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Body* original = snapshot.originals[slot];
+            // Staged copies are ours and safe to read here, the game's records only through the snapshot
+            const Body* source = m_latest[slot] ? m_latest[slot].get() : original;
+            const Body& contents = m_latest[slot] ? *m_latest[slot] : snapshot.bodies[slot];
+            if (!original) {
+                result.error = "No weapon record in that slot";
+            }
+            else if (BodyPtr body = stageCopy(source, &result.error)) {
+                Body copy = contents;
+                edit(copy);
+                std::memcpy(body.get(), &copy, sizeof(Body));
+                if (!rebaseNames(source, contents, *body)) {
+                    result.error = "Weapon name strings are out of reach of the staging memory";
+                }
+                else {
+                    m_latest[slot] = body;
+                    changes.push_back(StagedSlot{ slot, original, std::move(body) });
+                }
+            }
+        }
+
+        if (!result.error.isEmpty()) {
+            if (callback) callback(result);
+            return;
+        }
+        queueSwap(std::move(changes), QString(), callback);
+    }, callback);
+}
+
+void WeaponStaging::buildProfile(const QString& name, ProfileEdit edit, Callback callback)
+{
+    schedule([this, name, edit = std::move(edit), callback](const TableSnapshot& snapshot) {
+        // Edited as plain copies, the name offsets in them only mean something once rebased below
+        std::vector<Body> copies(snapshot.bodies.begin(), snapshot.bodies.end());
+        edit(copies);
+
+        WeaponStageResult result;
+        Profile profile;
+        for (int slot = 0; slot < SLOT_COUNT && result.error.isEmpty(); ++slot) {
+            Body* original = snapshot.originals[slot];
+            if (!original) continue;
+            if (std::memcmp(&copies[slot], &snapshot.bodies[slot], sizeof(Body)) == 0) {
+                profile.slots.push_back(StagedSlot{ slot, original, nullptr });
+                continue;
+            }
+
+            BodyPtr body = stageCopy(original, &result.error);
+            if (!body) break;
+            std::memcpy(body.get(), &copies[slot], sizeof(Body));
+            if (!rebaseNames(original, snapshot.bodies[slot], *body)) {
+                result.error = "Weapon name strings are out of reach of the staging memory";
+                break;
+            }
+            profile.slots.push_back(StagedSlot{ slot, original, std::move(body) });
+        }
+
+        if (result.error.isEmpty()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_profiles.insert(name, std::move(profile));
+        }
+        if (callback) callback(result);
+    }, callback);
+}
+
+bool WeaponStaging::activateProfile(const QString& name, Callback callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_profiles.contains(name)) return false;
+    }
+
+    // Scheduled like the others so it lands after edits requested before it
+    schedule([this, name, callback](const TableSnapshot&) {
+        std::vector<StagedSlot> changes;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_profiles.constFind(name);
+            if (it == m_profiles.constEnd()) return;
+            changes = it->slots;
+            for (const StagedSlot& change : changes) {
+                m_latest[change.slot] = change.body;
+            }
+        }
+        queueSwap(std::move(changes), name, callback);
+    }, callback);
+    return true;
+}
+
+void WeaponStaging::restoreOriginals(Callback callback)
+{
+    schedule([this, callback](const TableSnapshot& snapshot) {
+        std::vector<StagedSlot> changes;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+                if (!snapshot.originals[slot]) continue;
+                changes.push_back(StagedSlot{ slot, snapshot.originals[slot], nullptr });
+                m_latest[slot].reset();
+            }
+        }
+        queueSwap(std::move(changes), QString(), callback);
+    }, callback);
+}
+
+void WeaponStaging::queueSwap(std::vector<StagedSlot> changes, QString profile, Callback callback)
+{
+    try {
+        LunarTear::Get().QueuePhaseUpdateCallback([this, changes = std::move(changes), profile, callback]() {
+            WeaponStageResult result;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto table = GameData::instance().getWeaponSpecs();
+                for (const StagedSlot& change : changes) {
+                    if (!table.data() || syncSlot(table, change.slot) != change.basedOn) {
+                        ++result.stale;
+                        continue;
+                    }
+                    Body* target = change.body ? change.body.get() : change.basedOn;
+                    if (table[change.slot] == target) continue;
+
+                    table[change.slot] = target;
+                    // The game may have kept a pointer to the copy swapped out, its block is never reused
+                    retire(std::exchange(m_installed[change.slot], change.body));
+                    ++result.swapped;
+                }
+                m_activeProfile = profile;
+            }
+            if (callback) callback(result);
+        });
+    }
+    catch (const LunarTearUninitializedError& e) {
+        if (callback) callback(WeaponStageResult{ 0, 0, "Weapon records need the game to be running" });
+    }
+}
+
+void WeaponStaging::removeProfile(const QString& name)
+{
+    // Records of an active profile stay alive through m_installed until swapped out
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_profiles.remove(name);
+}
+
+QStringList WeaponStaging::profiles() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_profiles.keys();
+}
+
+QString WeaponStaging::activeProfile() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_activeProfile;
+}
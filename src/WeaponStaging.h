@@ -0,0 +1,102 @@
+#pragma once
+#include <replicant/weapon.h>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QThreadPool>
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+
+struct WeaponStageResult {
+    int swapped = 0; // Table slots pointed at a different record
+    int stale = 0;   // Skipped, the game replaced the record since it was staged from
+    QString error;   // Set when nothing was queued
+};
+
+// Weapon spec edits applied as whole records instead of field by field in place.
+//
+// A modified copy of a record is built on a worker thread, in memory allocated
+// close enough below the game's records that the copy's relative name offsets
+// can still reach their strings, and then the pointer in the spec table is
+// swapped on the game thread. Every swap of one request happens in the same
+// phase update, so the game never sees a half-written record or a mix of two
+// profiles. Profiles are sets of staged records kept ready for switching.
+//
+// The spec table and the original records are only read on the game thread, a
+// request snapshots them there first and is then staged on one worker, so
+// requests stay in order. Copies that were ever in the table are never reused,
+// the game may still hold a pointer to one. Callbacks run on the game thread.
+class WeaponStaging
+{
+public:
+    static constexpr int SLOT_COUNT = 64;
+
+    using Body = replicant::raw::RawWeaponBody;
+    using Callback = std::function<void(const WeaponStageResult&)>;
+    // Gets copies of the original records, indexed by slot, to modify
+    using ProfileEdit = std::function<void(std::span<Body> bodies)>;
+
+    static WeaponStaging& instance();
+
+    // Applies edit to a copy of the slot's latest record, including edits still queued.
+    // Name offsets of staged records are rebased to keep pointing at the original strings
+    void editWeapon(int slot, std::function<void(Body&)> edit, Callback callback = nullptr);
+
+    // Replaces the profile. Slots the edit leaves unchanged use the original record
+    void buildProfile(const QString& name, ProfileEdit edit, Callback callback = nullptr);
+    // Every slot gets the profile's record or the original one. False if there is no such profile
+    bool activateProfile(const QString& name, Callback callback = nullptr);
+    void removeProfile(const QString& name);
+    QStringList profiles() const;
+    QString activeProfile() const;
+
+    void restoreOriginals(Callback callback = nullptr);
+
+private:
+    WeaponStaging();
+    ~WeaponStaging();
+
+    WeaponStaging(const WeaponStaging&) = delete;
+    WeaponStaging& operator=(const WeaponStaging&) = delete;
+
+    using BodyPtr = std::shared_ptr<Body>;
+
+    struct StagedSlot {
+        int slot;
+        Body* basedOn; // Original record the copy was made from
+        BodyPtr body;  // Null puts the original back
+    };
+
+    struct Profile {
+        std::vector<StagedSlot> slots;
+    };
+
+    // The table as the game thread saw it when a request was picked up
+    struct TableSnapshot {
+        std::array<Body*, SLOT_COUNT> originals{}; // Null for empty slots
+        std::array<Body, SLOT_COUNT> bodies{};     // Copies of the originals' contents
+    };
+    using Stage = std::function<void(const TableSnapshot& snapshot)>;
+
+    // Game thread
+    Body* syncSlot(std::span<Body*> table, int slot);
+    void retire(BodyPtr body);
+
+    // Snapshots the table on the game thread, then runs stage on the worker
+    void schedule(Stage stage, Callback callback);
+    BodyPtr stageCopy(const Body* near, QString* error);
+    void queueSwap(std::vector<StagedSlot> changes, QString profile, Callback callback);
+
+    mutable std::mutex m_mutex;
+    std::array<Body*, SLOT_COUNT> m_originals{};
+    std::array<BodyPtr, SLOT_COUNT> m_installed; // Copies the table points at now
+    std::array<BodyPtr, SLOT_COUNT> m_latest;    // Last copy queued per slot, not necessarily swapped in yet
+    std::vector<BodyPtr> m_retired;              // Swapped out copies, kept so their memory is never handed out again
+    QHash<QString, Profile> m_profiles;
+    QString m_activeProfile;
+
+    QThreadPool m_pool;
+};
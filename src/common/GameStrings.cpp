@@ -1,20 +1,124 @@
 #include "GameStrings.h"
-#include <map>
+#include "GameData.h"
+#include <unordered_map>
+#include <shared_mutex>
+#include <vector>
+#include <QSet>
 #include <LunarTear++.h>
 
-std::unordered_map<int, std::string> g_gameStringCache;
+namespace {
+	constexpr int INVENTORY_STRING_BASE = 2000000;
+	constexpr int INVENTORY_STRING_STRIDE = 100;
+	constexpr int INVENTORY_SLOT_COUNT = 768;
 
-std::string GetGameString(int stringId) {
-	auto it = g_gameStringCache.find(stringId);
-	if (it != g_gameStringCache.end()) {
-		return it->second;
+	// Placeholder the game returns for IDs without text, the same in every language
+	const QString NO_TEXT = QStringLiteral("<NoText>");
+
+	std::shared_mutex g_cacheMutex;
+	std::unordered_map<int, QString> g_gameStringCache;
+	QSet<QString> g_internedStrings; // Identical texts share one buffer, most slots are "<NoText>"
+	// A prewarmed string with real text, read back to notice when the loaded language changes
+	int g_localeProbeId = -1;
+	QString g_localeProbe;
+
+	QString fetchGameString(int stringId) {
+		return QString::fromStdString(LunarTear::Get().Game().GetLocalizedString(stringId));
+	}
+
+	// Caller holds the write lock
+	const QString& insertLocked(int stringId, const QString& str) {
+		auto interned = g_internedStrings.constFind(str);
+		if (interned == g_internedStrings.constEnd()) {
+			interned = g_internedStrings.insert(str);
+		}
+		return g_gameStringCache.insert_or_assign(stringId, *interned).first->second;
 	}
-	std::string str = LunarTear::Get().Game().GetLocalizedString(stringId);
-	g_gameStringCache[stringId] = str;
-	return str;
 }
 
+std::string GetGameString(int stringId) {
+	return GetGameQString(stringId).toStdString();
+}
+
+QString GetItemName(int itemId) {
+	if (itemId < 0 || itemId >= INVENTORY_SLOT_COUNT) return QString();
+	QString name = GetGameQString(INVENTORY_STRING_BASE + INVENTORY_STRING_STRIDE * itemId);
+	return name == NO_TEXT ? QString() : name;
+}
 
 QString GetGameQString(int stringId) {
-	return QString::fromStdString(GetGameString(stringId));
+	{
+		std::shared_lock lock(g_cacheMutex);
+		auto it = g_gameStringCache.find(stringId);
+		if (it != g_gameStringCache.end()) {
+			return it->second;
+		}
+	}
+
+	QString str = fetchGameString(stringId);
+
+	std::unique_lock lock(g_cacheMutex);
+	return insertLocked(stringId, str);
+}
+
+void PrewarmGameStrings() {
+	CheckGameStringLocale();
+
+	std::vector<int> ids;
+	ids.reserve(INVENTORY_SLOT_COUNT + 64);
+	for (int i = 0; i < INVENTORY_SLOT_COUNT; ++i) {
+		ids.push_back(INVENTORY_STRING_BASE + INVENTORY_STRING_STRIDE * i);
+	}
+	for (auto* body : GameData::instance().getWeaponSpecs()) {
+		if (body) ids.push_back(body->nameStringID);
+	}
+
+	{
+		std::shared_lock lock(g_cacheMutex);
+		std::erase_if(ids, [](int id) { return g_gameStringCache.contains(id); });
+	}
+	if (ids.empty()) return;
+
+	// Fetch without holding the lock so UI readers aren't stalled behind the game
+	std::vector<QString> fetched;
+	fetched.reserve(ids.size());
+	for (int id : ids) {
+		fetched.push_back(fetchGameString(id));
+	}
+
+	std::unique_lock lock(g_cacheMutex);
+	for (size_t i = 0; i < ids.size(); ++i) {
+		insertLocked(ids[i], fetched[i]);
+	}
+	if (g_localeProbeId < 0) {
+		for (size_t i = 0; i < ids.size(); ++i) {
+			if (fetched[i].isEmpty() || fetched[i] == NO_TEXT) continue;
+			g_localeProbeId = ids[i];
+			g_localeProbe = fetched[i];
+			break;
+		}
+	}
+}
+
+void CheckGameStringLocale() {
+	int probeId;
+	{
+		std::shared_lock lock(g_cacheMutex);
+		probeId = g_localeProbeId;
+	}
+	if (probeId < 0) return;
+
+	QString current = fetchGameString(probeId);
+	{
+		std::shared_lock lock(g_cacheMutex);
+		if (g_localeProbeId != probeId || g_localeProbe == current) return;
+	}
+	InvalidateGameStrings();
+}
+
+void InvalidateGameStrings() {
+	std::unique_lock lock(g_cacheMutex);
+	g_gameStringCache.clear();
+	g_internedStrings.clear();
+	g_localeProbeId = -1;
+	g_localeProbe.clear();
 }
\ No newline at end of file
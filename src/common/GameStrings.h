@@ -2,4 +2,14 @@
 #include <string>
 
 std::string GetGameString(int stringId);
-QString GetGameQString(int stringId);
\ No newline at end of file
+QString GetGameQString(int stringId);
+
+// Name of an inventory slot's item. Null for slots without an item, which the game reports as "<NoText>"
+QString GetItemName(int itemId);
+
+// Fills the cache with inventory and weapon names in one go. Meant for the game thread
+void PrewarmGameStrings();
+
+// Drops the cache if the game's text no longer matches it, e.g. after a language change
+void CheckGameStringLocale();
+void InvalidateGameStrings();
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Atlas.h"
 #include "MapView.h"
 #include "GameData.h" 
+#include "Trajectory.h"
+#include "Actors.h"
 #include <LunarTear++.h>
 
 #include <QListWidget>
@@ -18,6 +20,7 @@
 #include <QJsonArray>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QFileDialog>
 #include <QDebug>
 #include <QSplitter>
 #include <QLineEdit>
@@ -26,15 +29,6 @@ namespace {
     std::string modId = "LTCon";
 }
 
-namespace {
-    QString getPointUniqueId(const TeleportPoint& point) {
-        return QString("%1@%2,%3,%4")
-            .arg(point.name)
-            .arg(point.pos.x())
-            .arg(point.pos.y())
-            .arg(point.pos.z());
-    }
-}
 
 Atlas::Atlas(QWidget* parent)
     : QWidget(parent)
@@ -47,8 +41,15 @@ Atlas::Atlas(QWidget* parent)
     }
     m_atlasDataDir = m_modBasePath + "/resource/atlas";
 
+    m_atlasIndex = new AtlasIndex(this);
+    m_atlasIndex->load(m_atlasDataDir, m_modBasePath + "/cache/atlas_index.bin");
+
     setupUi();
 
+    m_mapView->addLayer("trail", 0);
+    m_mapView->addLayer("points", 10);
+    m_mapView->addLayer("entities", 20);
+
     applyStyling();
     setupConnections();
     populateMapList();
@@ -65,6 +66,12 @@ void Atlas::setupUi()
     m_mapSearchBox->setPlaceholderText("Filter maps...");
     m_mapList = new QListWidget();
 
+    m_globalSearchBox = new QLineEdit();
+    m_globalSearchBox->setPlaceholderText("Search points in all maps...");
+    m_globalResultsList = new QListWidget();
+    m_globalResultsList->setToolTip("Click to open, double-click to teleport");
+    m_globalResultsList->hide();
+
     m_pointsSearchBox = new QLineEdit();
     m_pointsSearchBox->setPlaceholderText("Filter points by name or comment...");
     m_pointsTable = new QTableWidget();
@@ -79,6 +86,15 @@ void Atlas::setupUi()
     m_lockViewButton->setCheckable(true);
     m_lockViewButton->setChecked(true);
 
+    m_trailButton = new QPushButton("Trail");
+    m_trailButton->setCheckable(true);
+    m_trailButton->setToolTip("Record and draw the player's path");
+    m_clearTrailButton = new QPushButton("Clear Trail");
+    m_exportTrailButton = new QPushButton("Export Trail");
+    m_entitiesButton = new QPushButton("Entities");
+    m_entitiesButton->setCheckable(true);
+    m_entitiesButton->setToolTip("Show live actors on the map");
+
     m_calibrationControlsWidget = new QWidget();
     auto calibLayout = new QHBoxLayout(m_calibrationControlsWidget);
     m_instructionLabel = new QLabel("Calibration instructions will appear here.");
@@ -109,7 +125,9 @@ void Atlas::setupUi()
     auto leftWidget = new QWidget();
     auto leftLayout = new QVBoxLayout(leftWidget);
     leftLayout->addWidget(m_mapSearchBox);
-    leftLayout->addWidget(m_mapList);
+    leftLayout->addWidget(m_mapList, 2);
+    leftLayout->addWidget(m_globalSearchBox);
+    leftLayout->addWidget(m_globalResultsList, 1);
     leftLayout->setContentsMargins(0, 0, 0, 0);
 
     auto rightWidget = new QWidget();
@@ -129,6 +147,10 @@ void Atlas::setupUi()
     buttonBarLayout->addWidget(m_savePointButton);
     buttonBarLayout->addWidget(m_deletePointButton);
     buttonBarLayout->addStretch(1);
+    buttonBarLayout->addWidget(m_trailButton);
+    buttonBarLayout->addWidget(m_clearTrailButton);
+    buttonBarLayout->addWidget(m_exportTrailButton);
+    buttonBarLayout->addWidget(m_entitiesButton);
     buttonBarLayout->addWidget(m_calibrateButton);
     buttonBarLayout->addWidget(m_lockViewButton);
     bottomLayout->addLayout(buttonBarLayout);
@@ -210,6 +232,15 @@ void Atlas::setupConnections()
     connect(m_confirmCalibPointButton, &QPushButton::clicked, this, &Atlas::onConfirmCalibPointClicked);
     connect(m_cancelCalibButton, &QPushButton::clicked, this, &Atlas::onCancelCalibClicked);
     connect(m_pointsTable, &QTableWidget::itemDoubleClicked, this, &Atlas::onPointCommentDoubleClicked);
+    connect(m_trailButton, &QPushButton::toggled, this, &Atlas::onTrailToggled);
+    connect(m_clearTrailButton, &QPushButton::clicked, this, &Atlas::onClearTrailClicked);
+    connect(m_exportTrailButton, &QPushButton::clicked, this, &Atlas::onExportTrailClicked);
+    connect(m_entitiesButton, &QPushButton::toggled, this, &Atlas::onEntitiesToggled);
+    connect(m_mapView, &MapView::pointPicked, this, &Atlas::onMapPointPicked);
+    connect(m_globalSearchBox, &QLineEdit::textChanged, this, &Atlas::onGlobalSearchChanged);
+    connect(m_globalResultsList, &QListWidget::itemClicked, this, &Atlas::onGlobalResultClicked);
+    connect(m_globalResultsList, &QListWidget::itemDoubleClicked, this, &Atlas::onGlobalResultDoubleClicked);
+    connect(m_atlasIndex, &AtlasIndex::ready, this, [this]() { onGlobalSearchChanged(m_globalSearchBox->text()); });
 }
 
 void Atlas::onLockViewToggled(bool checked)
@@ -251,12 +282,9 @@ void Atlas::loadMapData(const QString& mapId)
     QJsonObject mapData = QJsonDocument::fromJson(file.readAll()).object();
     QString relativeImagePath = mapData["imageFile"].toString("resource/maps/default.png");
     QString absoluteImagePath = m_modBasePath + "/" + relativeImagePath;
-    QPixmap mapPixmap(absoluteImagePath);
-
-    if (mapPixmap.isNull()) {
+    if (!m_mapView->setMapImageFile(absoluteImagePath)) {
         qWarning() << "Atlas: Failed to load map image:" << absoluteImagePath;
     }
-    m_mapView->setMapImage(mapPixmap);
 
     QJsonObject calibObj = mapData["calibration"].toObject();
     m_currentCalibration.isCalibrated = calibObj["isCalibrated"].toBool(false);
@@ -267,28 +295,7 @@ void Atlas::loadMapData(const QString& mapId)
 
     m_lockViewButton->setChecked(true);
 
-    QJsonObject pointNotes = mapData["pointNotes"].toObject();
-    auto parsePoint = [](const QJsonObject& pointObj) {
-        TeleportPoint point;
-        point.name = pointObj["name"].toString();
-        const auto posObj = pointObj["pos"].toObject();
-        point.pos = QVector3D(posObj["x"].toDouble(), posObj["y"].toDouble(), posObj["z"].toDouble());
-        return point;
-        };
-    QJsonArray userPoints = mapData["userPoints"].toArray();
-    for (const QJsonValue& val : userPoints) {
-        TeleportPoint point = parsePoint(val.toObject());
-        point.isUserDefined = true;
-        point.comment = pointNotes.value(getPointUniqueId(point)).toString();
-        m_currentPoints.append(point);
-    }
-    QJsonArray gamePoints = mapData["gamePoints"].toArray();
-    for (const QJsonValue& val : gamePoints) {
-        TeleportPoint point = parsePoint(val.toObject());
-        point.isUserDefined = false;
-        point.comment = pointNotes.value(getPointUniqueId(point)).toString();
-        m_currentPoints.append(point);
-    }
+    m_currentPoints = parseTeleportPoints(mapData);
 
     populatePointsTable();
     m_mapView->setSelectedPoint(QPointF());
@@ -320,7 +327,7 @@ void Atlas::saveCurrentMapData()
         posObj["z"] = point.pos.z();
         pointObj["pos"] = posObj;
         if (!point.comment.isEmpty()) {
-            pointNotesObject[getPointUniqueId(point)] = point.comment;
+            pointNotesObject[teleportPointId(point)] = point.comment;
         }
         if (point.isUserDefined) {
             userPointsArray.append(pointObj);
@@ -340,6 +347,9 @@ void Atlas::saveCurrentMapData()
         return;
     }
     file.write(QJsonDocument(rootObject).toJson(QJsonDocument::Indented));
+    file.close();
+
+    m_atlasIndex->updateMap(m_currentMapId, m_currentPoints);
 }
 
 void Atlas::populatePointsTable() {
@@ -366,6 +376,8 @@ void Atlas::populatePointsTable() {
 
     m_pointsTable->setSortingEnabled(true);
     m_pointsTable->blockSignals(false);
+    rebuildPointSearchIndex();
+    refreshPointsLayer();
 
     if (previousRow >= 0 && previousRow < m_pointsTable->rowCount()) {
         m_pointsTable->setCurrentCell(previousRow, 0);
@@ -388,12 +400,18 @@ void Atlas::onMapSearchChanged(const QString& text) {
 }
 
 void Atlas::onPointSearchChanged(const QString& text) {
+    std::vector<char> matched(m_currentPoints.size(), 0);
+    for (int index : m_pointSearchIndex.search(text)) {
+        if (index < int(matched.size())) matched[index] = 1;
+    }
+
+    m_pointsTable->setUpdatesEnabled(false);
     for (int i = 0; i < m_pointsTable->rowCount(); ++i) {
-        QString name = m_pointsTable->item(i, 0)->text();
-        QString comment = m_pointsTable->item(i, 4)->text();
-        bool match = name.contains(text, Qt::CaseInsensitive) || comment.contains(text, Qt::CaseInsensitive);
+        int index = m_pointsTable->item(i, 0)->data(Qt::UserRole).toInt();
+        bool match = index >= 0 && index < int(matched.size()) && matched[index];
         m_pointsTable->setRowHidden(i, !match);
     }
+    m_pointsTable->setUpdatesEnabled(true);
 }
 
 void Atlas::onMapSelected() {
@@ -405,11 +423,15 @@ void Atlas::onMapSelected() {
         m_currentMapId.clear();
         m_currentPoints.clear();
         populatePointsTable();
-        m_mapView->setMapImage(QPixmap());
+        m_mapView->setMapImage(QImage());
+        m_mapView->setLayerPath("trail", QPolygonF(), QColor());
+        m_mapView->setLayerMarkers("points", {});
+        m_mapView->setLayerMarkers("entities", {});
         return;
     }
     loadMapData(currentItem->text());
     onPointSearchChanged(m_pointsSearchBox->text());
+    refreshTrajectory(true);
 }
 
 void Atlas::onPointSelected(QTableWidgetItem* current, QTableWidgetItem* previous) {
@@ -444,10 +466,6 @@ void Atlas::onPointSelected(QTableWidgetItem* current, QTableWidgetItem* previou
 
 void Atlas::onTeleportClicked()
 {
-    if (!GameData::instance().isGameActive()) {
-        QMessageBox::warning(this, "Teleport", "Cannot teleport, game is not in a playable state.");
-        return;
-    }
     auto selectedItems = m_pointsTable->selectedItems();
     if (selectedItems.isEmpty()) return;
 
@@ -455,8 +473,15 @@ void Atlas::onTeleportClicked()
     if (!nameItem) return;
 
     int originalIndex = nameItem->data(Qt::UserRole).toInt();
-    const TeleportPoint& point = m_currentPoints[originalIndex];
-    const QString targetMapId = m_currentMapId;
+    teleportTo(m_currentMapId, m_currentPoints[originalIndex]);
+}
+
+void Atlas::teleportTo(const QString& targetMapId, const TeleportPoint& point)
+{
+    if (!GameData::instance().isGameActive()) {
+        QMessageBox::warning(this, "Teleport", "Cannot teleport, game is not in a playable state.");
+        return;
+    }
     const QString playerCurrentMapId = GameData::instance().getCurrentPhase();
 
     if (targetMapId != playerCurrentMapId) {
@@ -475,6 +500,57 @@ void Atlas::onTeleportClicked()
     GameData::instance().teleportToPoint(targetMapId, point.pos, currentRot);
 }
 
+void Atlas::onGlobalSearchChanged(const QString& text)
+{
+    constexpr int MAX_RESULTS = 200;
+
+    m_globalResultsList->clear();
+    m_globalResults = m_atlasIndex->search(text, MAX_RESULTS);
+    m_globalResultsList->setVisible(!text.trimmed().isEmpty());
+
+    for (int i = 0; i < int(m_globalResults.size()); ++i) {
+        const AtlasSearchResult& result = m_globalResults[i];
+        auto item = new QListWidgetItem(QString("%1  [%2]").arg(result.point.name, result.mapId));
+        item->setData(Qt::UserRole, i);
+        if (!result.point.comment.isEmpty()) {
+            item->setToolTip(result.point.comment);
+        }
+        if (result.point.isUserDefined) {
+            item->setForeground(QColor("#c3e88d"));
+        }
+        m_globalResultsList->addItem(item);
+    }
+}
+
+void Atlas::onGlobalResultClicked(QListWidgetItem* item)
+{
+    int index = item->data(Qt::UserRole).toInt();
+    if (index < 0 || index >= int(m_globalResults.size())) return;
+    const AtlasSearchResult result = m_globalResults[index];
+
+    if (result.mapId != m_currentMapId) {
+        const QList<QListWidgetItem*> matches = m_mapList->findItems(result.mapId, Qt::MatchExactly);
+        if (matches.isEmpty()) return;
+        m_mapList->setCurrentItem(matches.first());
+    }
+
+    for (int i = 0; i < m_currentPoints.size(); ++i) {
+        const TeleportPoint& point = m_currentPoints[i];
+        if (point.name == result.point.name && point.pos == result.point.pos) {
+            onMapPointPicked(i);
+            return;
+        }
+    }
+}
+
+void Atlas::onGlobalResultDoubleClicked(QListWidgetItem* item)
+{
+    int index = item->data(Qt::UserRole).toInt();
+    if (index < 0 || index >= int(m_globalResults.size())) return;
+    const AtlasSearchResult result = m_globalResults[index];
+    teleportTo(result.mapId, result.point);
+}
+
 void Atlas::updatePlayerPosition()
 {
 
@@ -489,17 +565,135 @@ void Atlas::updatePlayerPosition()
 
     if (m_currentMapId.isEmpty() || !m_currentCalibration.isCalibrated) {
         m_mapView->setPlayerPosition(QPointF());
+        refreshEntitiesLayer(false);
         return;
     }
 
     if (m_currentPlayerPhase != m_currentMapId) {
         m_mapView->setPlayerPosition(QPointF());
+        refreshEntitiesLayer(false);
         return;
     }
 
     QVector3D playerPos = GameData::instance().getPlayerPosition();
     QPointF playerPixelPos = gameToPixel(playerPos);
     m_mapView->setPlayerPosition(playerPixelPos);
+    refreshTrajectory(false);
+    refreshEntitiesLayer(true);
+}
+
+void Atlas::refreshPointsLayer()
+{
+    std::vector<MapMarker> markers;
+    std::vector<QPointF> positions;
+    QStringList labels;
+    if (m_currentCalibration.isCalibrated) {
+        markers.reserve(m_currentPoints.size());
+        positions.reserve(m_currentPoints.size());
+        for (const TeleportPoint& point : m_currentPoints) {
+            MapMarker marker;
+            marker.pos = gameToPixel(point.pos);
+            marker.color = point.isUserDefined ? QColor("#c3e88d") : QColor("#c792ea");
+            marker.shape = point.isUserDefined ? MapMarker::Shape::Diamond : MapMarker::Shape::Dot;
+            marker.radius = point.isUserDefined ? 4.0 : 3.0;
+            markers.push_back(marker);
+            positions.push_back(marker.pos);
+            labels.append(point.comment.isEmpty() ? point.name : point.name + "\n" + point.comment);
+        }
+    }
+    // Pick indices line up with m_currentPoints
+    m_mapView->setPickablePoints(positions, labels);
+    m_mapView->setLayerMarkers("points", std::move(markers));
+}
+
+void Atlas::rebuildPointSearchIndex()
+{
+    QStringList documents;
+    documents.reserve(m_currentPoints.size());
+    for (const TeleportPoint& point : m_currentPoints) {
+        documents.append(point.name + '\n' + point.comment);
+    }
+    m_pointSearchIndex.build(documents);
+}
+
+void Atlas::onMapPointPicked(int index)
+{
+    for (int row = 0; row < m_pointsTable->rowCount(); ++row) {
+        QTableWidgetItem* nameItem = m_pointsTable->item(row, 0);
+        if (!nameItem || nameItem->data(Qt::UserRole).toInt() != index) continue;
+
+        // A filter could be hiding the picked point
+        if (m_pointsTable->isRowHidden(row)) {
+            m_pointsSearchBox->clear();
+        }
+        m_pointsTable->setCurrentCell(row, 0);
+        m_pointsTable->scrollToItem(nameItem);
+        return;
+    }
+}
+
+void Atlas::refreshEntitiesLayer(bool playerOnShownMap)
+{
+    std::vector<MapMarker> markers;
+    if (playerOnShownMap && m_entitiesButton->isChecked() && GameData::instance().isGameActive()) {
+        for (const EntityInfo& info : captureActorSnapshot()) {
+            // Actors without a position would all pile up on the map origin
+            if (!info.hasPosition || isPlayerActor(info)) continue;
+            MapMarker marker;
+            marker.pos = gameToPixel(info.position());
+            marker.color = isEnemyActor(info) ? QColor("#e06c75") : QColor("#e5c07b");
+            marker.radius = 3.0;
+            markers.push_back(marker);
+        }
+    }
+    m_mapView->setLayerMarkers("entities", std::move(markers));
+}
+
+void Atlas::onEntitiesToggled(bool checked)
+{
+    refreshEntitiesLayer(checked && !m_currentMapId.isEmpty() && m_currentCalibration.isCalibrated &&
+        m_currentPlayerPhase == m_currentMapId);
+}
+
+void Atlas::refreshTrajectory(bool force)
+{
+    const uint64_t revision = TrajectoryRecorder::instance().revision();
+    if (!force && revision == m_trailRevision) return;
+    m_trailRevision = revision;
+
+    QPolygonF path;
+    if (m_trailButton->isChecked() && !m_currentMapId.isEmpty() && m_currentCalibration.isCalibrated) {
+        std::vector<QVector3D> points = TrajectoryRecorder::instance().pointsInPhase(m_currentMapId);
+        path.reserve(static_cast<qsizetype>(points.size()));
+        for (const QVector3D& point : points) {
+            path.append(gameToPixel(point));
+        }
+    }
+    m_mapView->setLayerPath("trail", path, QColor(137, 221, 255, 160));
+}
+
+void Atlas::onTrailToggled(bool checked)
+{
+    TrajectoryRecorder::instance().setRecording(checked);
+    refreshTrajectory(true);
+}
+
+void Atlas::onClearTrailClicked()
+{
+    TrajectoryRecorder::instance().clear();
+    refreshTrajectory(true);
+}
+
+void Atlas::onExportTrailClicked()
+{
+    QString trailDir = m_modBasePath + "/trails";
+    QDir().mkpath(trailDir);
+    QString path = QFileDialog::getSaveFileName(this, "Export Trail", trailDir, "Trails (*.lttr)");
+    if (path.isEmpty()) return;
+
+    if (!TrajectoryRecorder::instance().exportToFile(path)) {
+        QMessageBox::warning(this, "Export Trail", "Could not write " + path);
+    }
 }
 
 
@@ -655,6 +849,8 @@ void Atlas::onConfirmCalibPointClicked() {
         m_currentCalibration.offsetY = m_calibGame1.z() - (m_calibPixel1.y() * m_currentCalibration.scaleY);
         m_currentCalibration.isCalibrated = true;
         saveCurrentMapData();
+        refreshTrajectory(true);
+        refreshPointsLayer();
         QMessageBox::information(this, "Success", "Map calibrated successfully!");
         onCancelCalibClicked();
     }
@@ -684,6 +880,8 @@ void Atlas::onPointCommentDoubleClicked(QTableWidgetItem* item) {
     if (ok && newComment != pointToEdit.comment) {
         pointToEdit.comment = newComment;
         item->setText(newComment);
+        rebuildPointSearchIndex();
+        refreshPointsLayer();
         saveCurrentMapData();
     }
 }
\ No newline at end of file
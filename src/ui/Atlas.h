@@ -6,6 +6,8 @@
 #include <QVector3D>
 #include <QPointF>
 #include <QTimer>
+#include "util/NgramIndex.h"
+#include "util/AtlasIndex.h"
 
 class QListWidget;
 class QTableWidget;
@@ -13,13 +15,7 @@ class QPushButton;
 class MapView;
 class QLabel;
 class QLineEdit;
-
-struct TeleportPoint {
-    QString name;
-    QVector3D pos;
-    bool isUserDefined;
-    QString comment;
-};
+class QListWidgetItem;
 
 struct MapCalibration {
     bool isCalibrated = false;
@@ -51,6 +47,14 @@ private slots:
     void onCancelCalibClicked();
     void onCalibrationPixelClicked(QPointF imagePos);
     void updatePlayerPosition();
+    void onTrailToggled(bool checked);
+    void onClearTrailClicked();
+    void onExportTrailClicked();
+    void onEntitiesToggled(bool checked);
+    void onMapPointPicked(int index);
+    void onGlobalSearchChanged(const QString& text);
+    void onGlobalResultClicked(QListWidgetItem* item);
+    void onGlobalResultDoubleClicked(QListWidgetItem* item);
 
 private:
     void setupUi();
@@ -63,17 +67,28 @@ private:
     void updateCalibrationUI();
     void updateMapListHighlight();
     QPointF gameToPixel(const QVector3D& gamePos) const;
+    void refreshTrajectory(bool force);
+    void refreshPointsLayer();
+    void rebuildPointSearchIndex();
+    void teleportTo(const QString& targetMapId, const TeleportPoint& point);
+    void refreshEntitiesLayer(bool playerOnShownMap);
 
     QListWidget* m_mapList;
     QTableWidget* m_pointsTable;
     MapView* m_mapView;
     QLineEdit* m_mapSearchBox;
     QLineEdit* m_pointsSearchBox;
+    QLineEdit* m_globalSearchBox;
+    QListWidget* m_globalResultsList;
     QPushButton* m_teleportButton;
     QPushButton* m_savePointButton;
     QPushButton* m_deletePointButton;
     QPushButton* m_calibrateButton;
     QPushButton* m_lockViewButton;
+    QPushButton* m_trailButton;
+    QPushButton* m_clearTrailButton;
+    QPushButton* m_exportTrailButton;
+    QPushButton* m_entitiesButton;
     QWidget* m_calibrationControlsWidget;
     QLabel* m_instructionLabel;
     QPushButton* m_confirmCalibPointButton;
@@ -83,8 +98,12 @@ private:
     QString m_currentMapId;
     QString m_currentPlayerPhase; 
     QList<TeleportPoint> m_currentPoints;
+    NgramIndex m_pointSearchIndex; // Over name and comment, indexed like m_currentPoints
+    AtlasIndex* m_atlasIndex;
+    std::vector<AtlasSearchResult> m_globalResults;
     MapCalibration m_currentCalibration;
     QTimer* m_playerUpdateTimer;
+    uint64_t m_trailRevision = 0;
     int m_calibrationState = 0;
     QPointF m_calibPixel1, m_calibPixel2;
     QVector3D m_calibGame1, m_calibGame2;
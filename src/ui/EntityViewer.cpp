@@ -9,80 +9,15 @@
 #include <QMessageBox>
 #include <QVector3D>
 #include <QMenu>
-
-
-#pragma pack(push, 1)
-struct CParamSet {
-    void** vtable;
-    char padding1[3 * 8];
-    int cparamsetforvehcile_id;
-    char padding2[89 * 8];
-    int health;
-    char padding3[6 * 8];
-    float x_pos;
-    float y_pos;
-    float z_pos;
-};
-
-struct cActor {
-    void* vtable;
-    cActor* prev_actor_primary;
-    cActor* next_actor_primary;
-    cActor* prev_actor_secondary;
-    cActor* next_actor_secondary;
-    char padding1[0x1B0];
-    int actor_id;
-    char padding2[0x14174];
-    CParamSet* cparams;
-};
-
-struct ActorListController {
-    cActor* head;
-    cActor* tail;
-    int64_t count;
-};
-
-struct ActorListControllerPair {
-    ActorListController primary_list;
-    ActorListController secondary_list;
-};
-#pragma pack(pop)
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QHBoxLayout>
 
 
 namespace {
-    constexpr uintptr_t MANAGER_ADDRESS_OFFSET = 0x2ca6e00;
-    constexpr uintptr_t RTTI_NAME_OFFSET = 0x10;
-
-    QString getRttiName(void* vtable) {
-        if (!vtable) return "N/A";
-        try {
-            uintptr_t rtti_col_ptr = *reinterpret_cast<uintptr_t*>(reinterpret_cast<uintptr_t>(vtable) - 8);
-            if (!rtti_col_ptr) return "N/A";
-
-            uintptr_t baseAddr = LunarTear::Get().Game().GetProcessBaseAddress();
-            uint32_t hierarchy_desc_rva = *reinterpret_cast<uint32_t*>(rtti_col_ptr + 0x10);
-            uintptr_t hierarchy_desc_addr = baseAddr + hierarchy_desc_rva;
-            uint32_t num_base_classes = *reinterpret_cast<uint32_t*>(hierarchy_desc_addr + 0x08);
-            if (num_base_classes == 0) return "N/A";
-
-            uint32_t base_class_array_rva = *reinterpret_cast<uint32_t*>(hierarchy_desc_addr + 0x0C);
-            uintptr_t base_class_array_addr = baseAddr + base_class_array_rva;
-            uint32_t desc_rva = *reinterpret_cast<uint32_t*>(base_class_array_addr);
-            uintptr_t type_desc_rva_ptr = baseAddr + desc_rva;
-            uint32_t type_desc_rva = *reinterpret_cast<uint32_t*>(type_desc_rva_ptr);
-            uintptr_t type_desc_addr = baseAddr + type_desc_rva;
-
-            char name_buffer[256];
-            memcpy(name_buffer, reinterpret_cast<void*>(type_desc_addr + RTTI_NAME_OFFSET), 255);
-            name_buffer[255] = '\0';
-
-            return QString(name_buffer).split("@@")[0].remove(".?AV");
-
-        }
-        catch (...) {
-            return "Parse Error";
-        }
-    }
+    constexpr float CAMERA_RAY_LENGTH = 200.0f;
 }
 
 EntityViewer::EntityViewer(QWidget* parent)
@@ -105,6 +40,23 @@ EntityViewer::EntityViewer(QWidget* parent)
 void EntityViewer::setupUi()
 {
     auto mainLayout = new QVBoxLayout(this);
+
+    auto filterLayout = new QHBoxLayout();
+    m_nearbyOnlyCheck = new QCheckBox("Nearby only");
+    m_nearbyModeCombo = new QComboBox();
+    m_nearbyModeCombo->addItem("Around Player");
+    m_nearbyModeCombo->addItem("Along Camera");
+    m_nearbyRadiusSpin = new QDoubleSpinBox();
+    m_nearbyRadiusSpin->setRange(1.0, 10000.0);
+    m_nearbyRadiusSpin->setValue(50.0);
+    m_nearbyRadiusSpin->setSuffix(" m");
+    m_teleportNearestEnemyButton = new QPushButton("Teleport to Nearest Enemy");
+    filterLayout->addWidget(m_nearbyOnlyCheck);
+    filterLayout->addWidget(m_nearbyModeCombo);
+    filterLayout->addWidget(m_nearbyRadiusSpin);
+    filterLayout->addStretch(1);
+    filterLayout->addWidget(m_teleportNearestEnemyButton);
+
     m_entityTable = new QTableWidget();
 
     m_entityTable->setColumnCount(6);
@@ -119,6 +71,7 @@ void EntityViewer::setupUi()
     header->setSectionResizeMode(QHeaderView::Interactive);
     header->setStretchLastSection(true);
 
+    mainLayout->addLayout(filterLayout);
     mainLayout->addWidget(m_entityTable);
 }
 
@@ -137,6 +90,9 @@ void EntityViewer::applyStyling()
         QHeaderView::section { background-color: %1; border: 1px solid %3; padding: 4px; }
         QMenu { background-color: #3a3f4b; border: 1px solid %3; }
         QMenu::item:selected { background-color: %4; }
+        QComboBox, QDoubleSpinBox { background-color: %5; border: 1px solid %3; border-radius: 4px; padding: 2px; }
+        QPushButton { background-color: #3a3f4b; border: 1px solid %3; border-radius: 4px; padding: 3px 8px; }
+        QPushButton:hover { background-color: #4b5162; }
         
     )").arg(bgColor, textColor, borderColor, highlightColor, secondaryBgColor);
     this->setStyleSheet(styleSheet);
@@ -145,84 +101,85 @@ void EntityViewer::applyStyling()
 void EntityViewer::setupConnections()
 {
     connect(m_entityTable, &QTableWidget::customContextMenuRequested, this, &EntityViewer::onContextMenuRequested);
+    connect(m_nearbyOnlyCheck, &QCheckBox::toggled, this, &EntityViewer::applyNearbyFilter);
+    connect(m_nearbyModeCombo, &QComboBox::currentIndexChanged, this, &EntityViewer::applyNearbyFilter);
+    connect(m_nearbyRadiusSpin, &QDoubleSpinBox::valueChanged, this, &EntityViewer::applyNearbyFilter);
+    connect(m_teleportNearestEnemyButton, &QPushButton::clicked, this, &EntityViewer::onTeleportToNearestEnemyClicked);
+}
+
+int EntityViewer::selectedEntityIndex() const
+{
+    int row = m_entityTable->currentRow();
+    if (row < 0) return -1;
+    QTableWidgetItem* addressItem = m_entityTable->item(row, 0);
+    if (!addressItem) return -1;
+    int index = addressItem->data(Qt::UserRole).toInt();
+    if (index < 0 || index >= static_cast<int>(m_entities.size())) return -1;
+    return index;
 }
 
 void EntityViewer::refreshEntityList()
 {
     if (!GameData::instance().isGameActive()) {
         m_entityTable->setRowCount(0);
+        m_entities.clear();
+        m_spatialIndex.clear();
         return;
     }
 
     uintptr_t selectedActorAddress = 0;
     int scrollPosition = 0;
-    int currentRow = m_entityTable->currentRow();
+    int selectedIndex = selectedEntityIndex();
 
-    if (currentRow >= 0 && currentRow < m_entities.size()) {
-        selectedActorAddress = m_entities[currentRow].pActor;
+    if (selectedIndex >= 0) {
+        selectedActorAddress = m_entities[selectedIndex].pActor;
         scrollPosition = m_entityTable->verticalScrollBar()->value();
     }
 
     m_entityTable->blockSignals(true);
     m_entityTable->setSortingEnabled(false);
 
-    m_entities.clear();
-
-    uintptr_t baseAddr = LunarTear::Get().Game().GetProcessBaseAddress();
-    auto* pManager = reinterpret_cast<ActorListControllerPair*>(baseAddr + MANAGER_ADDRESS_OFFSET);
-    ActorListController* list = &pManager->secondary_list;
-
-    cActor* currentActor = list->head;
-    if (currentActor) {
-        QVector3D playerPos = GameData::instance().getPlayerPosition();
-        do {
-            EntityInfo info;
-            info.pActor = reinterpret_cast<uintptr_t>(currentActor);
-            info.actorId = currentActor->actor_id;
-            info.rtti = getRttiName(currentActor->vtable);
-
-            //if (currentActor->cparams) {
-            //    info.hp = currentActor->cparams->health;
-            //    info.x = currentActor->cparams->x_pos;
-            //    info.y = currentActor->cparams->y_pos;
-            //    info.z = currentActor->cparams->z_pos;
-            //}
-            //else {
-                info.hp = -1;
-                info.x = info.y = info.z = 0.0f;
-            //}
-            m_entities.push_back(info);
-
-            currentActor = currentActor->next_actor_secondary;
-        } while (currentActor && currentActor != list->head);
-    }
-
+    m_entities = captureActorSnapshot();
 
+    std::vector<QVector3D> positions;
+    m_indexedEntities = positionedActors(m_entities, positions);
+    m_spatialIndex.build(positions);
 
     m_entityTable->setRowCount(m_entities.size());
     QVector3D playerPos = GameData::instance().getPlayerPosition();
     for (int i = 0; i < m_entities.size(); ++i) {
         const auto& info = m_entities[i];
-        QVector3D entityPos(info.x, info.y, info.z);
-        float distance = playerPos.distanceToPoint(entityPos);
 
-        m_entityTable->setItem(i, 0, new QTableWidgetItem(QString("0x%1").arg(info.pActor, 0, 16)));
+        auto* addressItem = new QTableWidgetItem(QString("0x%1").arg(info.pActor, 0, 16));
+        addressItem->setData(Qt::UserRole, i);
+        m_entityTable->setItem(i, 0, addressItem);
         m_entityTable->setItem(i, 1, new QTableWidgetItem(info.rtti));
         m_entityTable->setItem(i, 2, new QTableWidgetItem(QString::number(info.actorId)));
         m_entityTable->setItem(i, 3, new QTableWidgetItem(info.hp == -1 ? "N/A" : QString::number(info.hp)));
+        if (!info.hasPosition) {
+            m_entityTable->setItem(i, 4, new QTableWidgetItem("N/A"));
+            m_entityTable->setItem(i, 5, new QTableWidgetItem("N/A"));
+            continue;
+        }
         QString posString = QString("%1, %2, %3")
             .arg(info.x, 0, 'f', 2)
             .arg(info.y, 0, 'f', 2)
             .arg(info.z, 0, 'f', 2);
         m_entityTable->setItem(i, 4, new QTableWidgetItem(posString));
-        m_entityTable->setItem(i, 5, new QTableWidgetItem(QString::number(distance, 'f', 2)));
+        float distance = playerPos.distanceToPoint(info.position());
+        auto* distanceItem = new QTableWidgetItem();
+        distanceItem->setData(Qt::DisplayRole, static_cast<double>(qRound(distance * 100.0f)) / 100.0);
+        m_entityTable->setItem(i, 5, distanceItem);
     }
 
+    m_entityTable->setSortingEnabled(true);
+
     int newRowToSelect = -1;
     if (selectedActorAddress != 0) {
-        for (size_t i = 0; i < m_entities.size(); ++i) {
-            if (m_entities[i].pActor == selectedActorAddress) {
-                newRowToSelect = i;
+        for (int row = 0; row < m_entityTable->rowCount(); ++row) {
+            int index = m_entityTable->item(row, 0)->data(Qt::UserRole).toInt();
+            if (m_entities[index].pActor == selectedActorAddress) {
+                newRowToSelect = row;
                 break;
             }
         }
@@ -233,16 +190,45 @@ void EntityViewer::refreshEntityList()
         m_entityTable->verticalScrollBar()->setValue(scrollPosition);
     }
 
-    m_entityTable->setSortingEnabled(true);
+    applyNearbyFilter();
     m_entityTable->blockSignals(false);
 }
 
-void EntityViewer::onTeleportToPlayerClicked()
+void EntityViewer::applyNearbyFilter()
 {
-    if (m_entityTable->selectedItems().isEmpty()) return;
+    std::vector<bool> visible(m_entities.size(), true);
 
-    int selectedRow = m_entityTable->currentRow();
-    const auto& entityInfo = m_entities[selectedRow];
+    if (m_nearbyOnlyCheck->isChecked() && GameData::instance().isGameActive()) {
+        std::fill(visible.begin(), visible.end(), false);
+
+        QVector3D playerPos = GameData::instance().getPlayerPosition();
+        float radius = static_cast<float>(m_nearbyRadiusSpin->value());
+
+        std::vector<int> hits;
+        if (m_nearbyModeCombo->currentIndex() == 1) {
+            hits = m_spatialIndex.alongRay(playerPos, GameData::instance().getCameraForward(), CAMERA_RAY_LENGTH, radius);
+        }
+        else {
+            hits = m_spatialIndex.withinRadius(playerPos, radius);
+        }
+        for (int index : hits) {
+            visible[m_indexedEntities[index]] = true;
+        }
+    }
+
+    for (int row = 0; row < m_entityTable->rowCount(); ++row) {
+        QTableWidgetItem* addressItem = m_entityTable->item(row, 0);
+        if (!addressItem) continue;
+        int index = addressItem->data(Qt::UserRole).toInt();
+        m_entityTable->setRowHidden(row, index >= 0 && index < static_cast<int>(visible.size()) && !visible[index]);
+    }
+}
+
+void EntityViewer::onTeleportToPlayerClicked()
+{
+    int index = selectedEntityIndex();
+    if (index < 0) return;
+    const auto& entityInfo = m_entities[index];
 
     auto* actor = reinterpret_cast<cActor*>(entityInfo.pActor);
     if (actor && actor->cparams) {
@@ -255,14 +241,36 @@ void EntityViewer::onTeleportToPlayerClicked()
 
 void EntityViewer::onTeleportPlayerToEntityClicked()
 {
-    if (m_entityTable->selectedItems().isEmpty()) return;
+    int index = selectedEntityIndex();
+    if (index < 0) return;
+    const auto& entityInfo = m_entities[index];
+    if (!entityInfo.hasPosition) return;
 
-    int selectedRow = m_entityTable->currentRow();
-    const auto& entityInfo = m_entities[selectedRow];
-
-    QVector3D entityPos(entityInfo.x, entityInfo.y, entityInfo.z);
     float currentRot = GameData::instance().getPlayerRotationY();
-    GameData::instance().setPlayerPosition(entityPos, currentRot);
+    GameData::instance().setPlayerPosition(entityInfo.position(), currentRot);
+}
+
+void EntityViewer::onTeleportToNearestEnemyClicked()
+{
+    if (!GameData::instance().isGameActive() || m_spatialIndex.isEmpty()) return;
+
+    QVector3D playerPos = GameData::instance().getPlayerPosition();
+
+    // Enemies are usually a minority of the actor list, so widen k until one turns up
+    for (size_t k = 16; ; k *= 4) {
+        std::vector<int> candidates = m_spatialIndex.nearest(playerPos, k);
+        for (int index : candidates) {
+            const EntityInfo& candidate = m_entities[m_indexedEntities[index]];
+            if (isEnemyActor(candidate)) {
+                float currentRot = GameData::instance().getPlayerRotationY();
+                GameData::instance().setPlayerPosition(candidate.position(), currentRot);
+                return;
+            }
+        }
+        if (k >= m_spatialIndex.size()) break;
+    }
+
+    QMessageBox::information(this, "Teleport", "No enemies found in the current scene.");
 }
 
 void EntityViewer::onContextMenuRequested(const QPoint& pos)
@@ -3,17 +3,14 @@
 #include <QWidget>
 #include <QTableWidgetItem>
 #include <QTimer>
+#include "Actors.h"
+#include "util/SpatialIndex.h"
 
 class QTableWidget;
-
-struct EntityInfo {
-    uintptr_t pActor;
-    int actorId;
-    QString name;
-    QString rtti;
-    int hp;
-    float x, y, z;
-};
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QPushButton;
 
 class EntityViewer : public QWidget
 {
@@ -26,18 +23,27 @@ private slots:
     void refreshEntityList();
     void onTeleportToPlayerClicked();
     void onTeleportPlayerToEntityClicked();
+    void onTeleportToNearestEnemyClicked();
     void updateWidgetState();
+    void applyNearbyFilter();
     void onContextMenuRequested(const QPoint& pos);
 
 private:
     void setupUi();
     void applyStyling();
     void setupConnections();
+    int selectedEntityIndex() const;
 
     QTableWidget* m_entityTable;
+    QCheckBox* m_nearbyOnlyCheck;
+    QComboBox* m_nearbyModeCombo;
+    QDoubleSpinBox* m_nearbyRadiusSpin;
+    QPushButton* m_teleportNearestEnemyButton;
 
     QTimer* m_autoRefreshTimer;
     QTimer* m_stateUpdateTimer;
 
     std::vector<EntityInfo> m_entities;
-};
\ No newline at end of file
+    SpatialIndex m_spatialIndex; // Over the entities that have a position
+    std::vector<int> m_indexedEntities; // Index into m_entities of each point in m_spatialIndex
+};
@@ -1,5 +1,6 @@
 #include "Inspector.h"
 #include "GameData.h"
+#include "WeaponStaging.h"
 #include <LunarTear++.h>
 #include <QVBoxLayout>
 #include <QHeaderView>
@@ -9,6 +10,8 @@
 #include <QScrollBar>
 #include <QApplication>
 #include <QLineEdit>
+#include <QPointer>
+#include <cstring>
 #include <replicant/weapon.h> 
 
 using namespace replicant::raw;
@@ -558,14 +561,37 @@ void Inspector::onItemChanged(QTreeWidgetItem* item, int column)
             }
         }
 
+        // Edits go to a staged copy of the record that is swapped in whole, the game never reads it half written.
+        // One that doesn't make it in is logged and the tree re-read, so it doesn't show a value the game never got
+        QPointer<Inspector> self(this);
+        auto onStaged = [self, index](const WeaponStageResult& result) {
+            if (result.error.isEmpty() && result.stale == 0) return;
+            if (!result.error.isEmpty()) {
+                LunarTear::Get().Log(LT_LOG_WARNING) << "Weapon " << index << " edit not applied: " << result.error.toStdString();
+            }
+            else {
+                LunarTear::Get().Log(LT_LOG_WARNING) << "Weapon " << index << " edit not applied: the game replaced the record";
+            }
+            if (self) {
+                QMetaObject::invokeMethod(self, [self]() {
+                    if (self) self->refreshData();
+                }, Qt::QueuedConnection);
+            }
+        };
+        auto stage = [index, onStaged](size_t offset, auto value) {
+            WeaponStaging::instance().editWeapon(index, [offset, value](RawWeaponBody& staged) {
+                std::memcpy(reinterpret_cast<char*>(&staged) + offset, &value, sizeof(value));
+            }, onStaged);
+        };
+
         for (const auto& f : *tableToSearch) {
             if (f.id == fieldId) {
-                void* ptr = (char*)body + baseOffset + f.offset;
+                const size_t offset = baseOffset + f.offset;
 
-                if (f.type == TYPE_UINT) *(uint32_t*)ptr = newValue.toUInt(&ok);
-                else if (f.type == TYPE_INT) *(int32_t*)ptr = newValue.toInt(&ok);
-                else if (f.type == TYPE_FLOAT) *(float*)ptr = newValue.toFloat(&ok);
-                else if (f.type == TYPE_UINT8) *(uint8_t*)ptr = static_cast<uint8_t>(newValue.toUInt(&ok));
+                if (f.type == TYPE_UINT) stage(offset, newValue.toUInt(&ok));
+                else if (f.type == TYPE_INT) stage(offset, newValue.toInt(&ok));
+                else if (f.type == TYPE_FLOAT) stage(offset, newValue.toFloat(&ok));
+                else if (f.type == TYPE_UINT8) stage(offset, static_cast<uint8_t>(newValue.toUInt(&ok)));
                 break;
             }
         }
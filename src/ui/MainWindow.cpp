@@ -12,6 +12,7 @@
 #include "util/AtlasImporter.h"
 #include "InfoWidget.h"
 #include "EntityViewer.h"
+#include "WatchWidget.h"
 #include "LunarTear++.h"
 #include <iostream>
 
@@ -60,6 +61,7 @@ MainWindow::MainWindow() {
     Inspector* inspector = new Inspector();
 	Terminal* terminal = new Terminal();
     CutscenePlayer* cutscenePlayer = new CutscenePlayer();
+    WatchWidget* watchWidget = new WatchWidget();
 
     uint64_t termId = LuaConsoleManager::instance().registerTerminal(terminal);
    
@@ -100,6 +102,10 @@ MainWindow::MainWindow() {
     cutscenePlayerDock->setObjectName("CutscenePlayerDock");
     cutscenePlayerDock->setWidget(cutscenePlayer);
 
+    watchDock = new QDockWidget("Watches", this);
+    watchDock->setObjectName("WatchDock");
+    watchDock->setWidget(watchWidget);
+
     addDockWidget(Qt::BottomDockWidgetArea, terminalDock);
     addDockWidget(Qt::LeftDockWidgetArea, atlasDock);
     addDockWidget(Qt::RightDockWidgetArea, toolboxDock);
@@ -108,6 +114,7 @@ MainWindow::MainWindow() {
     addDockWidget(Qt::RightDockWidgetArea, infoWidgetDock);
     tabifyDockWidget(entityViewerDock, inspectorDock);
     tabifyDockWidget(entityViewerDock, cutscenePlayerDock);
+    tabifyDockWidget(entityViewerDock, watchDock);
 
     this->setDockOptions(QMainWindow::AllowNestedDocks | QMainWindow::AllowTabbedDocks);
 
@@ -120,6 +127,7 @@ MainWindow::MainWindow() {
     windowMenu->addAction(inspectorDock->toggleViewAction());
     windowMenu->addAction(infoWidgetDock->toggleViewAction());
     windowMenu->addAction(cutscenePlayerDock->toggleViewAction());
+    windowMenu->addAction(watchDock->toggleViewAction());
 
     QString modBasePath = QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon"));
 
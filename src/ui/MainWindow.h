@@ -25,6 +25,7 @@ private:
 	QDockWidget* infoWidgetDock;
 	QDockWidget* inspectorDock;
 	QDockWidget* cutscenePlayerDock;
+	QDockWidget* watchDock;
 
 	QTimer* m_saveStateTimer;
 
@@ -0,0 +1,104 @@
+#include "MapOverlay.h"
+#include <QtMath>
+
+void MapOverlayLayer::setMarkers(std::vector<MapMarker> markers)
+{
+    m_markers = std::move(markers);
+    m_grid.clear();
+    m_markerBounds = QRectF();
+    m_maxRadius = 0.0;
+
+    qreal left = 0, top = 0, right = 0, bottom = 0;
+    for (int i = 0; i < int(m_markers.size()); ++i) {
+        const MapMarker& marker = m_markers[i];
+        const int cellX = qFloor(marker.pos.x() / CELL_SIZE);
+        const int cellY = qFloor(marker.pos.y() / CELL_SIZE);
+        m_grid[cellKey(cellX, cellY)].push_back(i);
+
+        // Tracked by hand, QRectF drops zero-size rects when uniting
+        if (i == 0) {
+            left = right = marker.pos.x();
+            top = bottom = marker.pos.y();
+        }
+        else {
+            left = qMin(left, marker.pos.x());
+            right = qMax(right, marker.pos.x());
+            top = qMin(top, marker.pos.y());
+            bottom = qMax(bottom, marker.pos.y());
+        }
+        m_maxRadius = qMax(m_maxRadius, marker.radius);
+    }
+    if (!m_markers.empty()) {
+        m_markerBounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+    }
+}
+
+void MapOverlayLayer::setPath(const QPolygonF& path, const QColor& color)
+{
+    m_path = path;
+    m_pathColor = color;
+    m_pathBounds = path.boundingRect();
+    m_decimatedPath.clear();
+    m_decimatedScale = 0.0;
+}
+
+const QPolygonF& MapOverlayLayer::decimatedPath(qreal scale)
+{
+    if (m_decimatedScale == scale) {
+        return m_decimatedPath;
+    }
+
+    m_decimatedScale = scale;
+    m_decimatedPath.clear();
+    if (m_path.isEmpty() || scale <= 0.0) {
+        return m_decimatedPath;
+    }
+
+    const qreal tolerance = 1.0 / scale;
+    const qreal toleranceSq = tolerance * tolerance;
+
+    m_decimatedPath.reserve(m_path.size());
+    m_decimatedPath.append(m_path.first());
+    for (qsizetype i = 1; i < m_path.size() - 1; ++i) {
+        const QPointF delta = m_path[i] - m_decimatedPath.last();
+        if (QPointF::dotProduct(delta, delta) >= toleranceSq) {
+            m_decimatedPath.append(m_path[i]);
+        }
+    }
+    if (m_path.size() > 1) {
+        m_decimatedPath.append(m_path.last());
+    }
+    return m_decimatedPath;
+}
+
+void MapOverlayLayer::query(const QRectF& rect, std::vector<int>& out) const
+{
+    out.clear();
+    if (m_markers.empty() || rect.isEmpty()) return;
+
+    const int firstX = qFloor(rect.left() / CELL_SIZE);
+    const int lastX = qFloor(rect.right() / CELL_SIZE);
+    const int firstY = qFloor(rect.top() / CELL_SIZE);
+    const int lastY = qFloor(rect.bottom() / CELL_SIZE);
+
+    // Zoomed far out the rect can span more cells than exist, walking the grid is cheaper then
+    const qint64 cellCount = qint64(lastX - firstX + 1) * (lastY - firstY + 1);
+    if (cellCount > m_grid.size()) {
+        for (auto it = m_grid.cbegin(); it != m_grid.cend(); ++it) {
+            const int cellX = int(qint32(it.key() >> 32));
+            const int cellY = int(qint32(it.key() & 0xFFFFFFFF));
+            if (cellX < firstX || cellX > lastX || cellY < firstY || cellY > lastY) continue;
+            out.insert(out.end(), it.value().begin(), it.value().end());
+        }
+        return;
+    }
+
+    for (int y = firstY; y <= lastY; ++y) {
+        for (int x = firstX; x <= lastX; ++x) {
+            auto it = m_grid.constFind(cellKey(x, y));
+            if (it != m_grid.cend()) {
+                out.insert(out.end(), it.value().begin(), it.value().end());
+            }
+        }
+    }
+}
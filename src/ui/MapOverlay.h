@@ -0,0 +1,75 @@
+#pragma once
+#include <QString>
+#include <QColor>
+#include <QPointF>
+#include <QRectF>
+#include <QPolygonF>
+#include <QHash>
+#include <vector>
+
+struct MapMarker {
+    enum class Shape { Dot, Diamond, Cross };
+
+    QPointF pos;            // Source image pixels
+    QColor color;
+    Shape shape = Shape::Dot;
+    qreal radius = 4.0;     // Screen pixels, markers keep their size at every zoom
+
+    bool operator==(const MapMarker& other) const {
+        return pos == other.pos && color == other.color && shape == other.shape && radius == other.radius;
+    }
+};
+
+// A retained overlay layer: a set of markers plus an optional polyline, both in
+// source image coordinates. Markers are bucketed into a coarse grid so painting
+// only visits the cells that intersect the viewport.
+class MapOverlayLayer
+{
+public:
+    static constexpr qreal CELL_SIZE = 256.0;
+
+    MapOverlayLayer(const QString& name, int z) : m_name(name), m_z(z) {}
+
+    const QString& name() const { return m_name; }
+    int z() const { return m_z; }
+    void setZ(int z) { m_z = z; }
+
+    bool isVisible() const { return m_visible; }
+    void setVisible(bool visible) { m_visible = visible; }
+
+    void setMarkers(std::vector<MapMarker> markers);
+    const std::vector<MapMarker>& markers() const { return m_markers; }
+    qreal maxMarkerRadius() const { return m_maxRadius; }
+
+    void setPath(const QPolygonF& path, const QColor& color);
+    const QPolygonF& path() const { return m_path; }
+    const QColor& pathColor() const { return m_pathColor; }
+
+    // Drops points closer than one screen pixel to the last kept one, so the path
+    // costs the same to draw however long it is. Rebuilt only when the zoom changes
+    const QPolygonF& decimatedPath(qreal scale);
+
+    QRectF markerBounds() const { return m_markerBounds; }
+    QRectF pathBounds() const { return m_pathBounds; }
+
+    // Indices of markers in grid cells touching rect, may include a few just outside it
+    void query(const QRectF& rect, std::vector<int>& out) const;
+
+private:
+    static quint64 cellKey(int x, int y) { return (quint64(quint32(x)) << 32) | quint32(y); }
+
+    QString m_name;
+    int m_z;
+    bool m_visible = true;
+
+    std::vector<MapMarker> m_markers;
+    QHash<quint64, std::vector<int>> m_grid;
+    QRectF m_markerBounds;
+    qreal m_maxRadius = 0.0;
+
+    QPolygonF m_path;
+    QColor m_pathColor;
+    QRectF m_pathBounds;
+    QPolygonF m_decimatedPath;
+    qreal m_decimatedScale = 0.0;
+};
@@ -0,0 +1,157 @@
+#include "MapTilePyramid.h"
+#include <QPainter>
+#include <QImageReader>
+#include <QtMath>
+#include <cmath>
+
+MapTilePyramid::MapTilePyramid(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+MapTilePyramid::~MapTilePyramid()
+{
+    if (m_cancelled) m_cancelled->store(true);
+    m_pool.waitForDone();
+}
+
+int MapTilePyramid::levelCountFor(const QSize& size)
+{
+    int levels = 1;
+    int longest = qMax(size.width(), size.height());
+    while (longest > TILE_SIZE) {
+        longest = (longest + 1) / 2;
+        ++levels;
+    }
+    return levels;
+}
+
+MapTilePyramid::Level MapTilePyramid::cutLevel(const QImage& image)
+{
+    Level level;
+    level.size = image.size();
+    level.columns = (image.width() + TILE_SIZE - 1) / TILE_SIZE;
+    level.rows = (image.height() + TILE_SIZE - 1) / TILE_SIZE;
+    level.tiles.reserve(level.columns * level.rows);
+    for (int row = 0; row < level.rows; ++row) {
+        for (int column = 0; column < level.columns; ++column) {
+            const int x = column * TILE_SIZE;
+            const int y = row * TILE_SIZE;
+            level.tiles.append(image.copy(x, y, qMin(TILE_SIZE, image.width() - x), qMin(TILE_SIZE, image.height() - y)));
+        }
+    }
+    return level;
+}
+
+void MapTilePyramid::clear()
+{
+    if (m_cancelled) m_cancelled->store(true);
+    m_cancelled.reset();
+    ++m_generation;
+    m_sourceSize = QSize();
+    m_levels.clear();
+}
+
+void MapTilePyramid::build(const QImage& source)
+{
+    clear();
+    if (source.isNull()) return;
+    start(source.size(), [source]() { return source; });
+}
+
+bool MapTilePyramid::build(const QString& filePath)
+{
+    clear();
+    QImageReader reader(filePath);
+    const QSize size = reader.size();
+    if (!size.isValid() || size.isEmpty()) return false;
+    start(size, [filePath]() { return QImage(filePath); });
+    return true;
+}
+
+void MapTilePyramid::start(const QSize& size, std::function<QImage()> load)
+{
+    m_sourceSize = size;
+    m_levels.resize(levelCountFor(m_sourceSize));
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_cancelled = cancelled;
+    const uint64_t generation = m_generation;
+    const int levelCount = m_levels.size();
+
+    m_pool.start([this, load = std::move(load), size, cancelled, generation, levelCount]() {
+        // Premultiplied ARGB is the raster engine's fast path for drawImage
+        QImage image = load().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        if (image.size() != size) return;
+
+        for (int level = 0; level < levelCount; ++level) {
+            if (cancelled->load()) return;
+            if (level > 0) {
+                image = image.scaled(qMax(1, (image.width() + 1) / 2), qMax(1, (image.height() + 1) / 2),
+                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            }
+            Level data = cutLevel(image);
+            QMetaObject::invokeMethod(this, [this, generation, level, data = std::move(data)]() mutable {
+                publishLevel(generation, level, std::move(data));
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void MapTilePyramid::publishLevel(uint64_t generation, int level, Level data)
+{
+    // Results from a build that was replaced in the meantime
+    if (generation != m_generation || level >= m_levels.size()) return;
+    m_levels[level] = std::move(data);
+    emit levelReady(level);
+}
+
+int MapTilePyramid::readyLevelFor(qreal scale) const
+{
+    if (m_levels.isEmpty()) return -1;
+
+    // The finest level that is still at least as detailed as the screen
+    int wanted = 0;
+    if (scale > 0.0 && scale < 1.0) {
+        wanted = qFloor(std::log2(1.0 / scale));
+    }
+    wanted = qBound(0, wanted, int(m_levels.size()) - 1);
+
+    // Prefer a coarser stand-in while the wanted level is still being built, it's cheaper to draw
+    for (int level = wanted; level < m_levels.size(); ++level) {
+        if (!m_levels[level].tiles.isEmpty()) return level;
+    }
+    for (int level = wanted - 1; level >= 0; --level) {
+        if (!m_levels[level].tiles.isEmpty()) return level;
+    }
+    return -1;
+}
+
+void MapTilePyramid::paint(QPainter& painter, const QRectF& visibleRect, qreal scale) const
+{
+    const int levelIndex = readyLevelFor(scale);
+    if (levelIndex < 0) return;
+
+    const Level& level = m_levels[levelIndex];
+    const qreal toSourceX = qreal(m_sourceSize.width()) / level.size.width();
+    const qreal toSourceY = qreal(m_sourceSize.height()) / level.size.height();
+    const qreal tileWidth = TILE_SIZE * toSourceX;
+    const qreal tileHeight = TILE_SIZE * toSourceY;
+
+    const QRectF bounds = visibleRect.intersected(QRectF(QPointF(0, 0), QSizeF(m_sourceSize)));
+    if (bounds.isEmpty()) return;
+
+    const int firstColumn = qBound(0, qFloor(bounds.left() / tileWidth), level.columns - 1);
+    const int lastColumn = qBound(0, qFloor(bounds.right() / tileWidth), level.columns - 1);
+    const int firstRow = qBound(0, qFloor(bounds.top() / tileHeight), level.rows - 1);
+    const int lastRow = qBound(0, qFloor(bounds.bottom() / tileHeight), level.rows - 1);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const QImage& tile = level.tiles[row * level.columns + column];
+            QRectF target(column * tileWidth, row * tileHeight, tile.width() * toSourceX, tile.height() * toSourceY);
+            painter.drawImage(target, tile, QRectF(tile.rect()));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <QObject>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QRectF>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+class QPainter;
+
+// Mip pyramid of a map image cut into fixed-size tiles. Levels are generated once
+// on a worker thread; level n is the source halved n times. Painting only touches
+// the tiles that intersect the visible rect at the level matching the zoom.
+class MapTilePyramid : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TILE_SIZE = 256;
+
+    explicit MapTilePyramid(QObject* parent = nullptr);
+    ~MapTilePyramid();
+
+    // Cancels any build in progress. A null image just clears the pyramid
+    void build(const QImage& source);
+    // Decodes the file on the worker too. Returns false if the header can't be read
+    bool build(const QString& filePath);
+    void clear();
+
+    QSize sourceSize() const { return m_sourceSize; }
+    bool isEmpty() const { return m_sourceSize.isEmpty(); }
+
+    // visibleRect is in source image coordinates, scale is view pixels per image pixel
+    void paint(QPainter& painter, const QRectF& visibleRect, qreal scale) const;
+
+signals:
+    void levelReady(int level);
+
+private:
+    struct Level {
+        QSize size;
+        int columns = 0;
+        int rows = 0;
+        QList<QImage> tiles; // Row-major
+    };
+
+    static int levelCountFor(const QSize& size);
+    static Level cutLevel(const QImage& image);
+
+    void start(const QSize& size, std::function<QImage()> load);
+
+    int readyLevelFor(qreal scale) const;
+    void publishLevel(uint64_t generation, int level, Level data);
+
+    QSize m_sourceSize;
+    QList<Level> m_levels; // Empty size until the worker publishes it
+
+    QThreadPool m_pool;
+    uint64_t m_generation = 0;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
@@ -1,35 +1,203 @@
 #include "MapView.h"
+#include "MapTilePyramid.h"
 #include <QPainter>
 #include <QCursor>
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <QResizeEvent> 
+#include <QPaintEvent>
 #include <QStyle>
+#include <QToolTip>
+#include <QtMath>
+#include <algorithm>
 
 MapView::MapView(QWidget* parent)
     : QWidget(parent) 
+    , m_tiles(new MapTilePyramid(this))
 {
     setMinimumSize(400, 400);
     setStyleSheet("background-color: #1e1e1e;");
     setMouseTracking(true);
+    connect(m_tiles, &MapTilePyramid::levelReady, this, [this]() { update(); });
 }
 
-void MapView::setMapImage(const QPixmap& pixmap)
+void MapView::setMapImage(const QImage& image)
 {
-    m_mapPixmap = pixmap;
+    m_tiles->build(image);
     resetAndCenterView();
 }
 
+bool MapView::setMapImageFile(const QString& filePath)
+{
+    bool ok = m_tiles->build(filePath);
+    resetAndCenterView();
+    return ok;
+}
+
+// Image rect to widget rect, padded by screenPadding plus a little for outlines and antialiasing
+QRect MapView::toWidgetRect(const QRectF& imageRect, qreal screenPadding) const
+{
+    const int pad = qCeil(screenPadding) + 2;
+    return m_transform.mapRect(imageRect).toAlignedRect().adjusted(-pad, -pad, pad, pad);
+}
+
+QRect MapView::playerMarkerRect(const QPointF& pos) const
+{
+    if (pos.isNull()) return QRect();
+    return toWidgetRect(QRectF(pos - QPointF(6, 6), QSizeF(12, 12)), 1.5);
+}
+
+QRect MapView::selectionMarkerRect(const QPointF& pos) const
+{
+    if (pos.isNull()) return QRect();
+    return toWidgetRect(QRectF(pos - QPointF(8, 8), QSizeF(16, 16)), 1.5);
+}
+
+QRect MapView::markerRect(const MapMarker& marker) const
+{
+    return toWidgetRect(QRectF(marker.pos, QSizeF(0, 0)), marker.radius);
+}
+
+void MapView::updateLayerBounds(const MapOverlayLayer& layer)
+{
+    if (!layer.markers().empty()) {
+        update(toWidgetRect(layer.markerBounds(), layer.maxMarkerRadius()));
+    }
+    if (!layer.path().isEmpty()) {
+        update(toWidgetRect(layer.pathBounds(), 1.0));
+    }
+}
+
+MapOverlayLayer& MapView::ensureLayer(const QString& name, int z)
+{
+    for (auto& layer : m_layers) {
+        if (layer->name() == name) return *layer;
+    }
+    auto it = std::upper_bound(m_layers.begin(), m_layers.end(), z,
+        [](int value, const std::unique_ptr<MapOverlayLayer>& layer) { return value < layer->z(); });
+    return **m_layers.insert(it, std::make_unique<MapOverlayLayer>(name, z));
+}
+
+void MapView::addLayer(const QString& name, int z)
+{
+    MapOverlayLayer& layer = ensureLayer(name, z);
+    if (layer.z() == z) return;
+
+    layer.setZ(z);
+    std::stable_sort(m_layers.begin(), m_layers.end(),
+        [](const std::unique_ptr<MapOverlayLayer>& a, const std::unique_ptr<MapOverlayLayer>& b) { return a->z() < b->z(); });
+    updateLayerBounds(layer);
+}
+
+void MapView::setLayerMarkers(const QString& name, std::vector<MapMarker> markers)
+{
+    // Past this many moved markers one bounding rect is cheaper than tracking each
+    constexpr size_t MAX_TRACKED_CHANGES = 128;
+
+    MapOverlayLayer& layer = ensureLayer(name);
+    if (!layer.isVisible()) {
+        layer.setMarkers(std::move(markers));
+        return;
+    }
+
+    const std::vector<MapMarker>& old = layer.markers();
+    bool tracked = old.size() == markers.size();
+    std::vector<QRect> dirty;
+    for (size_t i = 0; tracked && i < markers.size(); ++i) {
+        if (old[i] == markers[i]) continue;
+        if (dirty.size() >= MAX_TRACKED_CHANGES * 2) {
+            tracked = false;
+            break;
+        }
+        dirty.push_back(markerRect(old[i]));
+        dirty.push_back(markerRect(markers[i]));
+    }
+
+    if (tracked) {
+        layer.setMarkers(std::move(markers));
+        for (const QRect& rect : dirty) update(rect);
+        return;
+    }
+
+    updateLayerBounds(layer);
+    layer.setMarkers(std::move(markers));
+    updateLayerBounds(layer);
+}
+
+void MapView::setLayerPath(const QString& name, const QPolygonF& path, const QColor& color)
+{
+    MapOverlayLayer& layer = ensureLayer(name);
+    const QPolygonF& old = layer.path();
+
+    // A trail that only grew at the end just needs its new tail repainted
+    const bool appended = layer.isVisible() && color == layer.pathColor() && !old.isEmpty() &&
+        path.size() >= old.size() && path.first() == old.first() && path[old.size() - 1] == old.last();
+
+    if (appended) {
+        QPolygonF tail(path.begin() + (old.size() - 1), path.end());
+        layer.setPath(path, color);
+        if (tail.size() > 1) update(toWidgetRect(tail.boundingRect(), 1.0));
+        return;
+    }
+
+    if (layer.isVisible() && !old.isEmpty()) update(toWidgetRect(layer.pathBounds(), 1.0));
+    layer.setPath(path, color);
+    if (layer.isVisible() && !path.isEmpty()) update(toWidgetRect(layer.pathBounds(), 1.0));
+}
+
+void MapView::setLayerVisible(const QString& name, bool visible)
+{
+    MapOverlayLayer& layer = ensureLayer(name);
+    if (layer.isVisible() == visible) return;
+    layer.setVisible(visible);
+    updateLayerBounds(layer);
+}
+
 void MapView::setPlayerPosition(const QPointF& pos)
 {
+    if (pos == m_playerPosition) return;
+    // Only the old and new marker areas need repainting, not the whole map
+    update(playerMarkerRect(m_playerPosition));
     m_playerPosition = pos;
-    update();
+    update(playerMarkerRect(m_playerPosition));
 }
 
 void MapView::setSelectedPoint(const QPointF& pos)
 {
+    update(selectionMarkerRect(m_selectedPoint));
     m_selectedPoint = pos;
-    update();
+    update(selectionMarkerRect(m_selectedPoint));
+}
+
+void MapView::setPickablePoints(const std::vector<QPointF>& positions, const QStringList& labels)
+{
+    setHoveredPoint(-1);
+    m_pickTree.build(positions);
+    m_pickLabels = labels;
+}
+
+// Nearest pickable point within a few screen pixels of the cursor, or -1
+int MapView::pickPoint(const QPoint& widgetPos) const
+{
+    constexpr qreal PICK_RADIUS = 8.0;
+    if (m_pickTree.isEmpty()) return -1;
+    return m_pickTree.nearest(m_transform.inverted().map(QPointF(widgetPos)), PICK_RADIUS / m_transform.m11());
+}
+
+QRect MapView::hoverRect(int index) const
+{
+    if (index < 0) return QRect();
+    QPointF center = m_transform.map(m_pickTree.point(index));
+    return QRectF(center - QPointF(9, 9), QSizeF(18, 18)).toAlignedRect();
+}
+
+void MapView::setHoveredPoint(int index)
+{
+    if (index == m_hoveredPoint) return;
+    update(hoverRect(m_hoveredPoint));
+    m_hoveredPoint = index;
+    update(hoverRect(m_hoveredPoint));
+    updateCursorShape();
 }
 
 const QTransform& MapView::getViewTransform() const
@@ -40,13 +208,13 @@ const QTransform& MapView::getViewTransform() const
 void MapView::resetAndCenterView()
 {
     m_transform.reset();
-    if (m_mapPixmap.isNull()) {
+    if (m_tiles->isEmpty()) {
         update();
         return;
     }
 
     const QSize widgetSize = this->size();
-    const QSize pixmapSize = m_mapPixmap.size();
+    const QSize pixmapSize = m_tiles->sourceSize();
 
     qreal scaleX = (qreal)widgetSize.width() / pixmapSize.width();
     qreal scaleY = (qreal)widgetSize.height() / pixmapSize.height();
@@ -104,6 +272,9 @@ void MapView::updateCursorShape()
     else if (m_isPanning) {
         setCursor(Qt::ClosedHandCursor);
     }
+    else if (m_hoveredPoint >= 0) {
+        setCursor(Qt::PointingHandCursor);
+    }
     else if (!m_isViewLocked) {
         setCursor(Qt::OpenHandCursor);
     }
@@ -114,13 +285,21 @@ void MapView::updateCursorShape()
 
 void MapView::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setClipRect(event->rect());
     painter.setTransform(m_transform);
 
-    if (!m_mapPixmap.isNull()) {
-        painter.drawPixmap(0, 0, m_mapPixmap);
+    // Tiles are picked at a level close to screen resolution, so the smooth filter stays cheap
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    const QRectF visibleRect = m_transform.inverted().mapRect(QRectF(event->rect()));
+    m_tiles->paint(painter, visibleRect, m_transform.m11());
+
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    for (auto& layer : m_layers) {
+        if (layer->isVisible()) {
+            paintLayer(painter, *layer, visibleRect);
+        }
     }
 
     const qreal penWidth = 1.5 / m_transform.m11();
@@ -131,6 +310,15 @@ void MapView::paintEvent(QPaintEvent* event)
         painter.drawLine(m_selectedPoint - QPointF(8, -8), m_selectedPoint + QPointF(8, -8));
     }
 
+    if (m_hoveredPoint >= 0) {
+        painter.save();
+        painter.resetTransform();
+        painter.setPen(QPen(QColor("#61afef"), 2.0));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawEllipse(m_transform.map(m_pickTree.point(m_hoveredPoint)), 7.0, 7.0);
+        painter.restore();
+    }
+
     if (!m_playerPosition.isNull()) {
         painter.setBrush(QColor("#89ddff"));
         painter.setPen(QPen(QColor("#282c34"), penWidth));
@@ -138,6 +326,52 @@ void MapView::paintEvent(QPaintEvent* event)
     }
 }
 
+void MapView::paintLayer(QPainter& painter, MapOverlayLayer& layer, const QRectF& visibleRect)
+{
+    const qreal scale = m_transform.m11();
+    const qreal pad = 2.0 / scale;
+
+    if (layer.path().size() > 1 && layer.pathBounds().adjusted(-pad, -pad, pad, pad).intersects(visibleRect)) {
+        painter.setPen(QPen(layer.pathColor(), 1.5 / scale, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPolyline(layer.decimatedPath(scale));
+    }
+
+    const qreal markerPad = (layer.maxMarkerRadius() + 2.0) / scale;
+    layer.query(visibleRect.adjusted(-markerPad, -markerPad, markerPad, markerPad), m_visibleMarkers);
+    if (m_visibleMarkers.empty()) return;
+
+    // Markers are sized in screen pixels, so they're drawn untransformed
+    painter.save();
+    painter.resetTransform();
+    for (int index : m_visibleMarkers) {
+        const MapMarker& marker = layer.markers()[index];
+        const QPointF center = m_transform.map(marker.pos);
+        const qreal r = marker.radius;
+
+        switch (marker.shape) {
+        case MapMarker::Shape::Dot:
+            painter.setPen(QPen(QColor("#282c34"), 1.0));
+            painter.setBrush(marker.color);
+            painter.drawEllipse(center, r, r);
+            break;
+        case MapMarker::Shape::Diamond: {
+            const QPointF diamond[4] = { center + QPointF(0, -r), center + QPointF(r, 0), center + QPointF(0, r), center + QPointF(-r, 0) };
+            painter.setPen(QPen(QColor("#282c34"), 1.0));
+            painter.setBrush(marker.color);
+            painter.drawConvexPolygon(diamond, 4);
+            break;
+        }
+        case MapMarker::Shape::Cross:
+            painter.setPen(QPen(marker.color, 1.5));
+            painter.drawLine(center - QPointF(r, r), center + QPointF(r, r));
+            painter.drawLine(center - QPointF(r, -r), center + QPointF(r, -r));
+            break;
+        }
+    }
+    painter.restore();
+}
+
 void MapView::resizeEvent(QResizeEvent* event)
 {
     QWidget::resizeEvent(event); 
@@ -169,6 +403,9 @@ void MapView::mousePressEvent(QMouseEvent* event)
         if (m_isCalibrationMode) {
             emit calibrationPointClicked(mapWidgetToImage(event->pos()));
         }
+        else if (m_hoveredPoint >= 0) {
+            emit pointPicked(m_hoveredPoint);
+        }
         else if (!m_isViewLocked) {
             m_isPanning = true;
             m_panLastMousePos = event->pos();
@@ -186,9 +423,27 @@ void MapView::mouseMoveEvent(QMouseEvent* event)
         double dy = delta.y() / m_transform.m22();
         m_transform.translate(dx, dy);
         update();
+        return;
+    }
+
+    if (!m_isCalibrationMode) {
+        int index = pickPoint(event->pos());
+        setHoveredPoint(index);
+        if (index >= 0 && index < m_pickLabels.size()) {
+            QToolTip::showText(event->globalPosition().toPoint(), m_pickLabels[index], this);
+        }
+        else {
+            QToolTip::hideText();
+        }
     }
 }
 
+void MapView::leaveEvent(QEvent* event)
+{
+    QWidget::leaveEvent(event);
+    setHoveredPoint(-1);
+}
+
 void MapView::mouseReleaseEvent(QMouseEvent* event)
 {
     if (event->button() == Qt::LeftButton && m_isPanning) {
@@ -1,8 +1,16 @@
 #pragma once
 #include <QWidget>
-#include <QPixmap>
+#include <QImage>
 #include <QPointF>
 #include <QTransform>
+#include <QPolygonF>
+#include <memory>
+#include <vector>
+#include "MapOverlay.h"
+#include "util/QuadTree.h"
+
+class MapTilePyramid;
+class QPainter;
 
 class MapView : public QWidget
 {
@@ -11,10 +19,21 @@ class MapView : public QWidget
 public:
     explicit MapView(QWidget* parent = nullptr);
 
-    void setMapImage(const QPixmap& pixmap);
+    void setMapImage(const QImage& image);
+    bool setMapImageFile(const QString& filePath); // Decoded in the background
     void setPlayerPosition(const QPointF& pos); // Position in SOURCE IMAGE pixel coordinates
     void setSelectedPoint(const QPointF& pos); // Position in SOURCE IMAGE pixel coordinates
 
+    // Overlay layers are drawn in z order between the map and the player marker.
+    // Setters create the layer at z 0 if it wasn't added first
+    void addLayer(const QString& name, int z);
+    void setLayerMarkers(const QString& name, std::vector<MapMarker> markers);
+    void setLayerPath(const QString& name, const QPolygonF& path, const QColor& color); // Oldest first
+    void setLayerVisible(const QString& name, bool visible);
+
+    // Points that can be hovered and clicked, indices are reported back through pointPicked
+    void setPickablePoints(const std::vector<QPointF>& positions, const QStringList& labels);
+
     const QTransform& getViewTransform() const;
 
 public slots:
@@ -25,6 +44,7 @@ public slots:
 
 signals:
     void calibrationPointClicked(QPointF imagePos);
+    void pointPicked(int index);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -33,15 +53,34 @@ protected:
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
+    void leaveEvent(QEvent* event) override;
 
 private:
     QPointF mapWidgetToImage(const QPoint& widgetPos);
     void updateCursorShape();
+    QRect playerMarkerRect(const QPointF& pos) const;
+    QRect selectionMarkerRect(const QPointF& pos) const;
 
-    QPixmap m_mapPixmap;
+    MapOverlayLayer& ensureLayer(const QString& name, int z = 0);
+    QRect toWidgetRect(const QRectF& imageRect, qreal screenPadding) const;
+    QRect markerRect(const MapMarker& marker) const;
+    void updateLayerBounds(const MapOverlayLayer& layer);
+    void paintLayer(QPainter& painter, MapOverlayLayer& layer, const QRectF& visibleRect);
+    int pickPoint(const QPoint& widgetPos) const;
+    void setHoveredPoint(int index);
+    QRect hoverRect(int index) const;
+
+    MapTilePyramid* m_tiles;
     QPointF m_playerPosition;   // Stored in image coordinates
     QPointF m_selectedPoint;    // Stored in image coordinates
 
+    std::vector<std::unique_ptr<MapOverlayLayer>> m_layers; // Sorted by z
+    std::vector<int> m_visibleMarkers; // Scratch for culling, reused across paints
+
+    QuadTree m_pickTree;
+    QStringList m_pickLabels;
+    int m_hoveredPoint = -1;
+
     QTransform m_transform;
     bool m_isPanning = false;
     QPoint m_panLastMousePos;
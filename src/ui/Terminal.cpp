@@ -10,13 +10,31 @@
 #include <QContextMenuEvent>
 #include <QTextBlock>
 #include <QTextDocumentFragment>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+#include "LuaSymbols.h"
+#include "ScriptRunner.h"
+#include <QPointer>
+#include <LunarTear++.h>
 #include <iostream>
 
+namespace {
+    constexpr int FLUSH_INTERVAL_MS = 16;
+    constexpr int DEFAULT_SCROLLBACK_LINES = 5000;
+    // terminal.log is moved to terminal.1.log once it grows past this
+    constexpr qint64 MAX_LOG_SIZE = 16 * 1024 * 1024;
+    // Candidates listed when Tab can't narrow the input any further
+    constexpr int COMPLETION_LIST_LIMIT = 64;
+}
+
 Terminal::Terminal(QWidget* parent)
     : QPlainTextEdit(parent),
     m_prompt(">> "),
     m_inputStartPosition(0),
-    m_historyPos(0)
+    m_historyPos(0),
+    m_scrollbackLines(DEFAULT_SCROLLBACK_LINES)
 {
     setStyleSheet("QPlainTextEdit {"
         "    background-color: #282c34;"
@@ -34,9 +52,68 @@ Terminal::Terminal(QWidget* parent)
         m_capsToggled = true;
     }
 
+    QString modBasePath;
+    try {
+        m_scrollbackLines = int(LunarTear::Get().GetConfigInt("Terminal", "ScrollbackLines", DEFAULT_SCROLLBACK_LINES));
+        modBasePath = QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon"));
+    }
+    catch (const LunarTearUninitializedError& e) {
+        // Running outside the game, keep the defaults and don't persist anything
+    }
+    if (m_scrollbackLines > 0) {
+        // The document drops its oldest blocks past this, the full text goes to the log
+        setMaximumBlockCount(m_scrollbackLines);
+    }
+    // Input is only ever edited on the prompt line, an undo stack would just hold every output ever printed
+    setUndoRedoEnabled(false);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &Terminal::flushOutput);
+
+    // Older history arrives after the first prompt, in front of anything typed meanwhile
+    connect(&m_history, &CommandHistory::loaded, this, [this](int count) {
+        m_historyPos += count;
+        if (m_searching) {
+            if (m_searchMatch >= 0) m_searchMatch += count;
+            findReverseSearchMatch(m_history.size());
+        }
+    });
+
+    if (!modBasePath.isEmpty()) {
+        openLog(modBasePath + "/logs");
+        m_history.load(modBasePath + "/logs/history.log");
+    }
     insertPrompt();
 }
 
+void Terminal::openLog(const QString& logDir)
+{
+    QDir().mkpath(logDir);
+    const QString logPath = logDir + "/terminal.log";
+
+    if (QFileInfo(logPath).size() > MAX_LOG_SIZE) {
+        const QString previous = logDir + "/terminal.1.log";
+        QFile::remove(previous);
+        QFile::rename(logPath, previous);
+    }
+
+    m_log.setFileName(logPath);
+    if (!m_log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Terminal: could not open" << logPath;
+        return;
+    }
+    writeLog(QString("-- session started %1 --").arg(QDateTime::currentDateTime().toString(Qt::ISODate)));
+}
+
+void Terminal::writeLog(const QString& text)
+{
+    if (!m_log.isOpen()) return;
+    m_log.write(text.toUtf8());
+    m_log.write("\n");
+    m_log.flush();
+}
+
 void Terminal::setPrompt(const QString& prompt)
 {
     m_prompt = prompt;
@@ -44,19 +121,51 @@ void Terminal::setPrompt(const QString& prompt)
 
 void Terminal::appendOutput(const QString& text)
 {
-    setReadOnly(false);
-
-    moveCursor(QTextCursor::End);
+    if (!text.isEmpty()) {
+        m_pendingOutput.append(text);
+        m_pendingLines += int(text.count('\n')) + 1;
+
+        // Lines that would be trimmed right after insertion are never laid out, they only reach the log
+        while (m_scrollbackLines > 0 && m_pendingLines > m_scrollbackLines && m_pendingOutput.size() > 1) {
+            const QString dropped = m_pendingOutput.takeFirst();
+            writeLog(dropped);
+            m_pendingLines -= int(dropped.count('\n')) + 1;
+        }
+    }
 
-    textCursor().insertText("\n");
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
 
-    if (!text.isEmpty()) {
-        textCursor().insertText(text);
-        textCursor().insertText("\n");
+void Terminal::flushOutput()
+{
+    // The prompt line is showing the search, the output waits until it ends
+    if (m_searching) {
+        m_flushDeferred = true;
+        return;
     }
 
-    textCursor().insertText(m_prompt);
+    const QString batch = m_pendingOutput.join('\n');
+    m_pendingOutput.clear();
+    m_pendingLines = 0;
+
+    setReadOnly(false);
+
+    QTextCursor cursor = textCursor();
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    cursor.insertText("\n");
+    if (!batch.isEmpty()) {
+        cursor.insertText(batch);
+        cursor.insertText("\n");
+        writeLog(batch);
+    }
+    cursor.insertText(m_prompt);
+    cursor.endEditBlock();
 
+    // Taken after the edit block closes, trimming old blocks shifts every position
+    moveCursor(QTextCursor::End);
     m_inputStartPosition = textCursor().position();
     scrollDown();
     setFocus();
@@ -90,6 +199,11 @@ void Terminal::keyPressEvent(QKeyEvent* e)
         m_capsToggled = !m_capsToggled; return;
     }
 
+    if (m_searching) {
+        reverseSearchKeyPress(e);
+        return;
+    }
+
     if (m_ctrlHeld)
     {
         switch (e->key()) {
@@ -113,6 +227,9 @@ void Terminal::keyPressEvent(QKeyEvent* e)
         case Qt::Key_V:
             if (!isReadOnly()) paste();
             return;
+        case Qt::Key_R:
+            if (!isReadOnly()) startReverseSearch();
+            return;
 
         case Qt::Key_Left:
         case Qt::Key_Right:
@@ -132,6 +249,10 @@ void Terminal::keyPressEvent(QKeyEvent* e)
         onCommandEntered();
         return;
     }
+    if (e->key() == Qt::Key_Tab) {
+        completeInput();
+        return;
+    }
     if (e->key() == Qt::Key_Up) {
         historyBack();
         return;
@@ -185,6 +306,15 @@ void Terminal::keyPressEvent(QKeyEvent* e)
     }
 
 
+    QChar inputChar = typedChar(e);
+    if (!inputChar.isNull())
+    {
+        insertPlainText(QString(inputChar));
+    }
+}
+
+QChar Terminal::typedChar(QKeyEvent* e) const
+{
     QChar inputChar;
     int key = e->key();
 
@@ -209,10 +339,7 @@ void Terminal::keyPressEvent(QKeyEvent* e)
         }
     }
 
-    if (!inputChar.isNull() && inputChar.isPrint())
-    {
-        insertPlainText(QString(inputChar));
-    }
+    return inputChar.isPrint() ? inputChar : QChar();
 }
 
 
@@ -254,14 +381,70 @@ void Terminal::copySelection()
     QApplication::clipboard()->setText(cleanedLines.join('\n'));
 }
 
+void Terminal::completeInput()
+{
+    QTextCursor cursor = textCursor();
+    if (isReadOnly() || cursor.hasSelection() || cursor.position() < m_inputStartPosition) return;
+
+    QTextCursor inputCursor(document());
+    inputCursor.setPosition(m_inputStartPosition);
+    inputCursor.setPosition(cursor.position(), QTextCursor::KeepAnchor);
+    const QString beforeCursor = inputCursor.selectedText();
+
+    // The name being typed, table fields included
+    qsizetype start = beforeCursor.size();
+    while (start > 0) {
+        const QChar c = beforeCursor[start - 1];
+        if (!(c.isLetterOrNumber() || c == '_' || c == '.')) break;
+        --start;
+    }
+    const QString prefix = beforeCursor.mid(start);
+    if (prefix.isEmpty()) return;
+
+    const LuaCompletionResult result = LuaSymbolIndex::instance().complete(prefix, COMPLETION_LIST_LIMIT);
+    if (result.total == 0) return;
+
+    if (result.commonPrefix.size() > prefix.size()) {
+        cursor.insertText(result.commonPrefix.mid(prefix.size()));
+        if (result.total == 1 && result.matches.front().kind == LuaSymbolKind::Function) {
+            cursor.insertText("(");
+        }
+        setTextCursor(cursor);
+        return;
+    }
+    if (result.total == 1) return;
+
+    // Nothing left to fill in, list the candidates above the prompt and leave the input alone
+    QStringList names;
+    for (const LuaCompletion& match : result.matches) {
+        names << match.name;
+    }
+    QString listing = names.join("  ");
+    if (result.total > int(result.matches.size())) {
+        listing += QString("  ... %1 more").arg(result.total - int(result.matches.size()));
+    }
+
+    QTextCursor listCursor(document()->lastBlock());
+    listCursor.insertText(listing + "\n");
+    m_inputStartPosition = document()->lastBlock().position() + m_prompt.size();
+    scrollDown();
+}
+
 void Terminal::onCommandEntered()
 {
     QString command = document()->lastBlock().text().mid(m_prompt.length()).trimmed();
 
     if (!command.isEmpty()) {
+        writeLog(m_prompt + command);
+        LuaSymbolIndex::instance().learnFromCommand(command);
         m_history.append(command);
         m_historyPos = m_history.size();
-        emit commandEntered(command);
+        if (command.startsWith(':')) {
+            runConsoleCommand(command.mid(1));
+        }
+        else {
+            emit commandEntered(command);
+        }
 
 
         setReadOnly(true);
@@ -272,6 +455,38 @@ void Terminal::onCommandEntered()
 }
  
 
+// Commands for the console itself rather than Lua, written with a leading ':'
+void Terminal::runConsoleCommand(const QString& command)
+{
+    const QString name = command.section(' ', 0, 0);
+    const QString argument = command.section(' ', 1).trimmed();
+
+    if (name == "scripts") {
+        const QStringList scripts = ScriptRunner::instance().availableScripts();
+        appendOutput(scripts.isEmpty()
+            ? QString("No scripts in %1").arg(ScriptRunner::instance().scriptDirectory())
+            : scripts.join('\n'));
+        return;
+    }
+
+    if (name == "run" && !argument.isEmpty()) {
+        QPointer<Terminal> self(this);
+        QString error;
+        bool queued = ScriptRunner::instance().run(argument, [self](const ScriptRunResult& result) {
+            QString text = result.ok ? result.output : QString("LTCON Error: %1").arg(result.output);
+            if (self) {
+                QMetaObject::invokeMethod(self, "appendOutput", Qt::QueuedConnection, Q_ARG(QString, text));
+            }
+        }, &error);
+        if (!queued) {
+            appendOutput(QString("LTCON Error: %1").arg(error));
+        }
+        return;
+    }
+
+    appendOutput("Console commands:\n  :run <script>   run a .lua file from the scripts folder\n  :scripts        list them");
+}
+
 void Terminal::insertPrompt(bool forceNewLine)
 {
     moveCursor(QTextCursor::End);
@@ -291,30 +506,139 @@ void Terminal::scrollDown()
 
 void Terminal::historyBack()
 {
-    if (m_history.isEmpty() || m_historyPos == 0) return;
+    if (m_history.size() == 0 || m_historyPos == 0) return;
 
     --m_historyPos;
-    QTextCursor cursor = textCursor();
-    cursor.setPosition(m_inputStartPosition);
-    cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
-    cursor.removeSelectedText();
-    cursor.insertText(m_history.at(m_historyPos));
+    replaceInput(m_history.at(m_historyPos));
 }
 
 void Terminal::historyForward()
 {
-    if (m_history.isEmpty()) return;
+    if (m_history.size() == 0) return;
 
+    if (m_historyPos < m_history.size() - 1) {
+        ++m_historyPos;
+        replaceInput(m_history.at(m_historyPos));
+    }
+    else {
+        m_historyPos = m_history.size();
+        replaceInput(QString());
+    }
+}
+
+void Terminal::replaceInput(const QString& text)
+{
     QTextCursor cursor = textCursor();
     cursor.setPosition(m_inputStartPosition);
     cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
     cursor.removeSelectedText();
+    cursor.insertText(text);
+}
 
-    if (m_historyPos < m_history.size() - 1) {
-        ++m_historyPos;
-        cursor.insertText(m_history.at(m_historyPos));
+void Terminal::startReverseSearch()
+{
+    QTextCursor cursor(document());
+    cursor.setPosition(m_inputStartPosition);
+    cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+
+    m_searching = true;
+    m_searchOriginalInput = cursor.selectedText();
+    m_searchQuery.clear();
+    findReverseSearchMatch(m_history.size());
+}
+
+void Terminal::findReverseSearchMatch(int before)
+{
+    const int match = m_history.searchBackward(m_searchQuery, before);
+    m_searchFailing = match < 0 && !m_searchQuery.isEmpty();
+    // A failed step keeps showing the last thing that did match
+    if (match >= 0 || m_searchQuery.isEmpty()) {
+        m_searchMatch = match;
+    }
+
+    QString shown = m_searchMatch >= 0 ? m_history.at(m_searchMatch) : QString();
+    shown.replace('\n', ' ');
+
+    QTextCursor cursor(document()->lastBlock());
+    cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+    cursor.insertText(QString("(%1reverse-i-search)`%2': %3")
+        .arg(m_searchFailing ? "failing " : "", m_searchQuery, shown));
+    setTextCursor(cursor);
+    scrollDown();
+}
+
+void Terminal::reverseSearchKeyPress(QKeyEvent* e)
+{
+    if (m_ctrlHeld) {
+        switch (e->key()) {
+        case Qt::Key_R:
+            findReverseSearchMatch(m_searchMatch >= 0 ? m_searchMatch : m_history.size());
+            return;
+        case Qt::Key_G:
+        case Qt::Key_C:
+            endReverseSearch(false);
+            return;
+        default:
+            return;
+        }
+    }
+
+    switch (e->key()) {
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        endReverseSearch(true);
+        onCommandEntered();
+        return;
+    case Qt::Key_Escape:
+        endReverseSearch(false);
+        return;
+    case Qt::Key_Backspace:
+        if (!m_searchQuery.isEmpty()) {
+            m_searchQuery.chop(1);
+            findReverseSearchMatch(m_history.size());
+        }
+        return;
+    case Qt::Key_Left:
+    case Qt::Key_Right:
+    case Qt::Key_Up:
+    case Qt::Key_Down:
+    case Qt::Key_Home:
+    case Qt::Key_End:
+    case Qt::Key_Tab:
+        endReverseSearch(true);
+        return;
+    default:
+        break;
+    }
+
+    const QChar inputChar = typedChar(e);
+    if (inputChar.isNull()) return;
+
+    // The current match stays if it still contains the longer query
+    m_searchQuery += inputChar;
+    findReverseSearchMatch(m_searchMatch >= 0 ? m_searchMatch + 1 : m_history.size());
+}
+
+void Terminal::endReverseSearch(bool accept)
+{
+    m_searching = false;
+
+    QTextCursor cursor(document()->lastBlock());
+    cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+    cursor.insertText(m_prompt);
+    m_inputStartPosition = cursor.position();
+
+    if (accept && m_searchMatch >= 0) {
+        cursor.insertText(m_history.at(m_searchMatch));
+        m_historyPos = m_searchMatch;
     }
     else {
-        m_historyPos = m_history.size();
+        cursor.insertText(m_searchOriginalInput);
+    }
+    setTextCursor(cursor);
+
+    if (m_flushDeferred) {
+        m_flushDeferred = false;
+        m_flushTimer.start();
     }
-}
\ No newline at end of file
+}
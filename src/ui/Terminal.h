@@ -3,6 +3,9 @@
 #include <QPlainTextEdit>
 #include <QKeyEvent>
 #include <QStringList>
+#include <QTimer>
+#include <QFile>
+#include "util/CommandHistory.h"
 
 class Terminal : public QPlainTextEdit
 {
@@ -27,19 +30,47 @@ protected:
 
 private:
     void onCommandEntered();
+    void runConsoleCommand(const QString& command);
     void insertPrompt(bool forceNewLine = false);
     void scrollDown();
     void historyBack();
     void historyForward();
+    void replaceInput(const QString& text);
+    void startReverseSearch();
+    void reverseSearchKeyPress(QKeyEvent* e);
+    void findReverseSearchMatch(int before);
+    void endReverseSearch(bool accept);
+    QChar typedChar(QKeyEvent* e) const;
     void copySelection();
+    void completeInput();
+    void flushOutput();
+    void openLog(const QString& logDir);
+    void writeLog(const QString& text);
 
     QString m_prompt;
     int m_inputStartPosition;
-    QStringList m_history;
+    CommandHistory m_history;
     int m_historyPos;
 
+    // Ctrl+R. While it runs the prompt line shows the query and the match instead of the input
+    bool m_searching = false;
+    bool m_searchFailing = false;
+    QString m_searchQuery;
+    int m_searchMatch = -1;
+    QString m_searchOriginalInput;
+    bool m_flushDeferred = false;
+
     bool m_shiftHeld;
     bool m_ctrlHeld;
     bool m_capsToggled;
 
+    // Output arriving within one flush interval is inserted as a single edit block
+    QStringList m_pendingOutput;
+    int m_pendingLines = 0;
+    int m_scrollbackLines;
+    QTimer m_flushTimer;
+
+    // Everything shown in the terminal, including lines scrolled out of the widget
+    QFile m_log;
+
 };
\ No newline at end of file
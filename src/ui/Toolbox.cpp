@@ -1,6 +1,7 @@
 #include "Toolbox.h"
 #include "GameData.h"
 #include "Patch.h" 
+#include "PatchRegistry.h"
 
 #include <QPushButton>
 #include <QComboBox>
@@ -15,10 +16,17 @@
 #include <QGroupBox>
 #include <QMessageBox>
 #include <QIntValidator>
+#include <QFileDialog>
+#include <QFile>
+#include <QDir>
+#include <QPointer>
+#include <QSignalBlocker>
 #include <vector>
 #include <Callbacks.h>
 #include "MapView.h"
-#include <Windows.h> 
+#include "Noclip.h"
+#include "Inventory.h"
+#include "SaveStates.h"
 #include <cmath>
 
 namespace {
@@ -28,18 +36,6 @@ namespace {
         1.0f, // Default
         1.25f, 1.5f, 2.0f, 3.0f, 5.0f, 7.5f, 10.0f, 15.0f, 20.0f, 50.0f, 100.0f, 300.0f, 500.0f
     };
-
-    struct CameraMatrix {
-        float m[4][4];
-    };
-
-    const CameraMatrix* getCameraMatrix() {
-        uintptr_t baseAddr = LunarTear::Get().Game().GetProcessBaseAddress();
-        if (!baseAddr) return nullptr;
-        uintptr_t camManagerAddr = baseAddr + 0x32e7a00;
-        if (!camManagerAddr) return nullptr;
-        return (const CameraMatrix*)(camManagerAddr + 0x240);
-    }
 }
 
 Toolbox::Toolbox(QWidget* parent)
@@ -52,9 +48,6 @@ Toolbox::Toolbox(QWidget* parent)
     m_stateUpdateTimer = new QTimer(this);
     connect(m_stateUpdateTimer, &QTimer::timeout, this, &Toolbox::updateButtonStates);
     m_stateUpdateTimer->start(300); 
-
-    m_flyUpdateTimer = new QTimer(this);
-    connect(m_flyUpdateTimer, &QTimer::timeout, this, &Toolbox::onFlyUpdate);
 }
 
 void Toolbox::setupUi()
@@ -65,7 +58,6 @@ void Toolbox::setupUi()
     auto playerTogglesGroup = new QGroupBox();
     auto playerTogglesLayout = new QGridLayout(playerTogglesGroup);
     m_invincibleButton = new QPushButton("Invincibility");
-    m_infiniteJumpButton = new QPushButton("Infinite Jump");
 
 
     m_flyLabel = new QLabel("Noclip Speed");
@@ -74,15 +66,36 @@ void Toolbox::setupUi()
     m_flySensSlider->setRange(1, 100);
     m_flySensSlider->setValue(20);
 
-    m_infiniteJumpButton->setCheckable(true); 
     m_invincibleButton->setCheckable(true);
     m_flyButton->setCheckable(true);
 
-    playerTogglesLayout->addWidget(m_flyButton, 0, 2);
-    playerTogglesLayout->addWidget(m_flyLabel, 1, 0);
-    playerTogglesLayout->addWidget(m_flySensSlider, 1, 1, 1, 2);
-    playerTogglesLayout->addWidget(m_invincibleButton, 0, 1);
-    playerTogglesLayout->addWidget(m_infiniteJumpButton, 0, 0);
+    std::vector<QPushButton*> toggleButtons = { m_invincibleButton, m_flyButton };
+
+    // One toggle per data-driven patch
+    PatchRegistry& registry = PatchRegistry::instance();
+    for (const auto& def : registry.definitions()) {
+        if (!def.showInToolbox) continue;
+
+        auto button = new QPushButton(def.name);
+        button->setCheckable(true);
+        if (registry.isAvailable(def.id)) {
+            button->setToolTip(def.description);
+        }
+        else {
+            button->setEnabled(false);
+            button->setToolTip(registry.errorString(def.id));
+        }
+        m_patchToggles.push_back({ def.id, button });
+        toggleButtons.push_back(button);
+    }
+
+    const int toggleColumns = 3;
+    int toggleRows = (static_cast<int>(toggleButtons.size()) + toggleColumns - 1) / toggleColumns;
+    for (int i = 0; i < static_cast<int>(toggleButtons.size()); ++i) {
+        playerTogglesLayout->addWidget(toggleButtons[i], i / toggleColumns, i % toggleColumns);
+    }
+    playerTogglesLayout->addWidget(m_flyLabel, toggleRows, 0);
+    playerTogglesLayout->addWidget(m_flySensSlider, toggleRows, 1, 1, 2);
 
     mainLayout->addWidget(playerTogglesGroup);
 
@@ -121,6 +134,27 @@ void Toolbox::setupUi()
 
     mainLayout->addWidget(progressionGroup);
 
+    auto loadoutGroup = new QGroupBox("Inventory Loadout");
+    auto loadoutLayout = new QHBoxLayout(loadoutGroup);
+    m_saveLoadoutButton = new QPushButton("Save Loadout");
+    m_loadLoadoutButton = new QPushButton("Load Loadout");
+    loadoutLayout->addWidget(m_saveLoadoutButton);
+    loadoutLayout->addWidget(m_loadLoadoutButton);
+    mainLayout->addWidget(loadoutGroup);
+
+    auto saveStateGroup = new QGroupBox("Save States");
+    auto saveStateLayout = new QHBoxLayout(saveStateGroup);
+    m_saveStateSlotComboBox = new QComboBox();
+    m_saveStateButton = new QPushButton("Save State");
+    m_loadStateButton = new QPushButton("Load State");
+    saveStateLayout->addWidget(m_saveStateSlotComboBox, 1);
+    saveStateLayout->addWidget(m_saveStateButton);
+    saveStateLayout->addWidget(m_loadStateButton);
+    mainLayout->addWidget(saveStateGroup);
+
+    SaveStateManager::instance().load(saveStateFilePath());
+    refreshSaveStateSlots();
+
     auto characterGroup = new QGroupBox();
     auto characterLayout = new QHBoxLayout(characterGroup);
     characterLayout->addWidget(new QLabel("Override Player Character:"));
@@ -206,8 +240,12 @@ void Toolbox::applyStyling()
 void Toolbox::setupConnections()
 {
     connect(m_invincibleButton, &QPushButton::toggled, this, &Toolbox::onInvincibleClicked);
-    connect(m_infiniteJumpButton, &QPushButton::toggled, this, &Toolbox::onInfiniteJumpToggled);
+    for (const auto& toggle : m_patchToggles) {
+        QString id = toggle.id;
+        connect(toggle.button, &QPushButton::toggled, this, [this, id](bool checked) { onPatchToggled(id, checked); });
+    }
     connect(m_flyButton, &QPushButton::toggled, this, &Toolbox::onFlyToggled);
+    connect(m_flySensSlider, &QSlider::valueChanged, this, &Toolbox::onFlySpeedChanged);
 
     connect(m_maxHpMpButton, &QPushButton::clicked, this, &Toolbox::onMaxHpMpClicked);
     connect(m_maxStatsButton, &QPushButton::clicked, this, &Toolbox::onMaxStatsClicked);
@@ -220,6 +258,10 @@ void Toolbox::setupConnections()
     connect(m_maxMoneyButton, &QPushButton::clicked, this, &Toolbox::onMaxMoneyClicked);
     connect(m_maxItemsButton, &QPushButton::clicked, this, &Toolbox::onMaxItemsClicked);
     connect(m_changeLevelButton, &QPushButton::clicked, this, &Toolbox::onChangeLevelClicked);
+    connect(m_saveLoadoutButton, &QPushButton::clicked, this, &Toolbox::onSaveLoadoutClicked);
+    connect(m_loadLoadoutButton, &QPushButton::clicked, this, &Toolbox::onLoadLoadoutClicked);
+    connect(m_saveStateButton, &QPushButton::clicked, this, &Toolbox::onSaveStateClicked);
+    connect(m_loadStateButton, &QPushButton::clicked, this, &Toolbox::onLoadStateClicked);
 
     connect(m_spawnKaineButton, &QPushButton::clicked, this, &Toolbox::onSpawnKaineClicked);
     connect(m_spawnEmilButton, &QPushButton::clicked, this, &Toolbox::onSpawnEmilClicked);
@@ -230,69 +272,33 @@ void Toolbox::setupConnections()
 
 
 void Toolbox::onInvincibleClicked(bool checked) { GameData::instance().setInvincible(checked); }
-void Toolbox::onInfiniteJumpToggled(bool checked)
+void Toolbox::onPatchToggled(const QString& id, bool checked)
 {
-    if (checked) {
-        PatchInfiniteJump();
-    }
-    else {
-        UnpatchInfiniteJump();
-    }
-    m_isInfiniteJumpPatched = checked;
+    PatchRegistry::instance().setEnabled(id, checked);
 }
 
 void Toolbox::onFlyToggled(bool checked)
 {
     if (checked) {
-        PatchNoMove();
-        m_flyUpdateTimer->start(16);
+        // Without the patch the game keeps moving the player and fights the noclip
+        if (!PatchNoMove()) {
+            QSignalBlocker blocker(m_flyButton);
+            m_flyButton->setChecked(false);
+            QMessageBox::warning(this, "Noclip", "Could not patch player movement: " + PatchRegistry::instance().errorString("no_move"));
+            return;
+        }
     }
     else {
         UnpatchNoMove();
-        m_flyUpdateTimer->stop();
     }
+    NoclipController::instance().setEnabled(checked);
     m_isFlyPatched = checked;
 
 }
 
-void Toolbox::onFlyUpdate()
+void Toolbox::onFlySpeedChanged(int value)
 {
-    if (!m_isFlyPatched || !GameData::instance().isGameActive()) {
-        return;
-    }
-
-    ActorPlayable* player = LunarTear::Get().Game().GetActorPlayable();
-    const CameraMatrix* cameraMatrix = getCameraMatrix();
-
-    if (!player || !cameraMatrix) {
-        return;
-    }
-
-    float sensitivity = m_flySensSlider->value() / 20.0f;
-
-    QVector3D forward(cameraMatrix->m[0][2], cameraMatrix->m[1][2], cameraMatrix->m[2][2]);
-
-    QVector3D right(cameraMatrix->m[0][0], cameraMatrix->m[1][0], cameraMatrix->m[2][0]);
-
-    QVector3D worldUp(0.0f, 1.0f, 0.0f);
-
-    QVector3D totalMove(0.0f, 0.0f, 0.0f);
-
-    if (GetAsyncKeyState('W') & 0x8000) totalMove += forward;
-    if (GetAsyncKeyState('S') & 0x8000) totalMove -= forward;
-    if (GetAsyncKeyState('A') & 0x8000) totalMove += right;
-    if (GetAsyncKeyState('D') & 0x8000) totalMove -= right;
-    if (GetAsyncKeyState(VK_SPACE) & 0x8000) totalMove += worldUp;
-    if (GetAsyncKeyState(VK_SHIFT) & 0x8000) totalMove -= worldUp;
-
-    if (totalMove.isNull()) return;
-
-    totalMove.normalize();
-    totalMove *= sensitivity;
-
-    player->posX += totalMove.x();
-    player->posY += totalMove.y();
-    player->posZ += totalMove.z();
+    NoclipController::instance().setSpeed(value / 20.0f * NoclipController::DEFAULT_SPEED);
 }
 
 
@@ -335,6 +341,84 @@ void Toolbox::onRestartRestorePosClicked() {
 
 void Toolbox::onMaxMoneyClicked() { GameData::instance().setMaxMoney(); }
 void Toolbox::onMaxItemsClicked() { GameData::instance().setMaxItems(); }
+void Toolbox::onSaveLoadoutClicked()
+{
+    QPointer<Toolbox> self(this);
+    Inventory::capture([self](const std::optional<InventorySnapshot>& snapshot) {
+        if (!snapshot || !self) return;
+        QByteArray blob = Inventory::exportLoadout(*snapshot);
+        QMetaObject::invokeMethod(self, [self, blob]() {
+            if (self) self->saveLoadout(blob);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Toolbox::saveLoadout(const QByteArray& blob)
+{
+    QString loadoutDir = QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon")) + "/loadouts";
+    QDir().mkpath(loadoutDir);
+    QString path = QFileDialog::getSaveFileName(this, "Save Loadout", loadoutDir, "Loadouts (*.ltiv)");
+    if (path.isEmpty()) return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(blob) != blob.size()) {
+        QMessageBox::warning(this, "Save Loadout", "Could not write " + path);
+    }
+}
+
+void Toolbox::onLoadLoadoutClicked()
+{
+    QString loadoutDir = QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon")) + "/loadouts";
+    QString path = QFileDialog::getOpenFileName(this, "Load Loadout", loadoutDir, "Loadouts (*.ltiv)");
+    if (path.isEmpty()) return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || !Inventory::importLoadout(file.readAll())) {
+        QMessageBox::warning(this, "Load Loadout", "Not a valid loadout file: " + path);
+    }
+}
+
+QString Toolbox::saveStateFilePath() const
+{
+    return QString::fromStdString(LunarTear::Get().GetModDirectory("LTCon")) + "/savestates.ltss";
+}
+
+void Toolbox::refreshSaveStateSlots()
+{
+    int current = std::max(0, m_saveStateSlotComboBox->currentIndex());
+    m_saveStateSlotComboBox->clear();
+    for (int i = 0; i < SaveStateManager::SLOT_COUNT; ++i) {
+        SaveStateInfo info = SaveStateManager::instance().slotInfo(i);
+        QString label = info.used
+            ? QString("Slot %1: %2 (%3)").arg(i + 1).arg(info.phase, info.created.toString("MM-dd hh:mm:ss"))
+            : QString("Slot %1: Empty").arg(i + 1);
+        m_saveStateSlotComboBox->addItem(label, i);
+    }
+    m_saveStateSlotComboBox->setCurrentIndex(current);
+}
+
+void Toolbox::onSaveStateClicked()
+{
+    int slot = m_saveStateSlotComboBox->currentData().toInt();
+    QPointer<Toolbox> self(this);
+    SaveStateManager::instance().capture(slot, [self](bool captured) {
+        if (!captured || !self) return;
+        QMetaObject::invokeMethod(self, [self]() {
+            if (!self) return;
+            if (!SaveStateManager::instance().save(self->saveStateFilePath())) {
+                QMessageBox::warning(self, "Save State", "State captured but could not be written to disk.");
+            }
+            self->refreshSaveStateSlots();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Toolbox::onLoadStateClicked()
+{
+    int slot = m_saveStateSlotComboBox->currentData().toInt();
+    SaveStateManager::instance().restore(slot);
+}
+
 void Toolbox::onChangeLevelClicked()
 {
     bool ok;
@@ -385,7 +469,9 @@ void Toolbox::updateButtonStates()
     this->setEnabled(isActive);
 
     if (isActive) {
-        m_infiniteJumpButton->setChecked(m_isInfiniteJumpPatched);
+        for (const auto& toggle : m_patchToggles) {
+            toggle.button->setChecked(PatchRegistry::instance().isEnabled(toggle.id));
+        }
         m_flyButton->setChecked(m_isFlyPatched);
     }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <QWidget>
+#include <vector>
 
 class QPushButton;
 class QSlider;
@@ -17,9 +18,9 @@ public:
 
 private slots:
     void onInvincibleClicked(bool checked);
-    void onInfiniteJumpToggled(bool checked);
+    void onPatchToggled(const QString& id, bool checked);
     void onFlyToggled(bool checked);
-    void onFlyUpdate();
+    void onFlySpeedChanged(int value);
 
 
     void onMaxHpMpClicked();
@@ -32,6 +33,10 @@ private slots:
 
     void onMaxMoneyClicked();
     void onMaxItemsClicked();
+    void onSaveLoadoutClicked();
+    void onLoadLoadoutClicked();
+    void onSaveStateClicked();
+    void onLoadStateClicked();
     void onChangeLevelClicked();
 
     void onSpawnKaineClicked();
@@ -46,9 +51,17 @@ private:
     void setupUi();
     void setupConnections();
     void applyStyling();
+    void refreshSaveStateSlots();
+    QString saveStateFilePath() const;
+    void saveLoadout(const QByteArray& blob);
 
     QPushButton* m_invincibleButton;
-    QPushButton* m_infiniteJumpButton;
+
+    struct PatchToggle {
+        QString id;
+        QPushButton* button;
+    };
+    std::vector<PatchToggle> m_patchToggles;
 
     QLabel* m_flyLabel;
     QPushButton* m_flyButton;
@@ -66,6 +79,12 @@ private:
 
     QPushButton* m_maxMoneyButton;
     QPushButton* m_maxItemsButton;
+    QPushButton* m_saveLoadoutButton;
+    QPushButton* m_loadLoadoutButton;
+
+    QComboBox* m_saveStateSlotComboBox;
+    QPushButton* m_saveStateButton;
+    QPushButton* m_loadStateButton;
     QPushButton* m_changeLevelButton;
 
     QComboBox* m_playerCharacterComboBox;
@@ -79,9 +98,7 @@ private:
     QPushButton* m_teleportCoordsButton;
 
     QTimer* m_stateUpdateTimer;
-    QTimer* m_flyUpdateTimer;
 
-    bool m_isInfiniteJumpPatched = false;
     bool m_isFlyPatched = false;
 };
 
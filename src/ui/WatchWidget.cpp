@@ -0,0 +1,174 @@
+#include "WatchWidget.h"
+
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QComboBox>
+#include <QPushButton>
+#include <QPlainTextEdit>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QSplitter>
+#include <QHash>
+
+namespace {
+    constexpr int EVENT_LOG_MAX_LINES = 500;
+}
+
+WatchWidget::WatchWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setupUi();
+    applyStyling();
+    setupConnections();
+
+    // Sampling happens every game frame, this only controls how often the table is redrawn
+    m_refreshTimer = new QTimer(this);
+    connect(m_refreshTimer, &QTimer::timeout, this, &WatchWidget::refreshWatches);
+    m_refreshTimer->start(100);
+}
+
+void WatchWidget::setupUi()
+{
+    auto mainLayout = new QVBoxLayout(this);
+
+    auto addLayout = new QHBoxLayout();
+    m_fieldCombo = new QComboBox();
+    m_fieldCombo->setEditable(true);
+    m_fieldCombo->addItems(knownWatchFields());
+    m_fieldCombo->lineEdit()->setPlaceholderText("Field or address, e.g. 0x7ff6a000:f32");
+    m_addButton = new QPushButton("Add Watch");
+    m_removeButton = new QPushButton("Remove");
+    addLayout->addWidget(m_fieldCombo, 1);
+    addLayout->addWidget(m_addButton);
+    addLayout->addWidget(m_removeButton);
+
+    m_watchTable = new QTableWidget();
+    m_watchTable->setColumnCount(6);
+    m_watchTable->setHorizontalHeaderLabels({ "Watch", "Value", "Min", "Max", "Changes", "Rate/s" });
+    m_watchTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_watchTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_watchTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_watchTable->verticalHeader()->setVisible(false);
+    m_watchTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    auto logLayout = new QHBoxLayout();
+    m_clearLogButton = new QPushButton("Clear Log");
+    logLayout->addStretch(1);
+    logLayout->addWidget(m_clearLogButton);
+
+    m_eventLog = new QPlainTextEdit();
+    m_eventLog->setReadOnly(true);
+    m_eventLog->setMaximumBlockCount(EVENT_LOG_MAX_LINES);
+
+    auto splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_watchTable);
+    splitter->addWidget(m_eventLog);
+
+    mainLayout->addLayout(addLayout);
+    mainLayout->addWidget(splitter, 1);
+    mainLayout->addLayout(logLayout);
+}
+
+void WatchWidget::applyStyling()
+{
+    const QString bgColor = "#282c34";
+    const QString textColor = "#abb2bf";
+    const QString borderColor = "#2c313a";
+    const QString highlightColor = "#61afef";
+    const QString secondaryBgColor = "#21252b";
+
+    QString styleSheet = QString(R"(
+        QWidget { background-color: %1; color: %2; font-family: 'Consolas', 'Courier New', monospace; }
+        QTableWidget { background-color: %5; border: 1px solid %3; gridline-color: %3; }
+        QTableWidget::item:selected { background-color: %4; color: %5; }
+        QHeaderView::section { background-color: %1; border: 1px solid %3; padding: 4px; }
+        QPlainTextEdit { background-color: %5; border: 1px solid %3; }
+        QComboBox { background-color: %5; border: 1px solid %3; border-radius: 4px; padding: 2px; }
+        QComboBox QAbstractItemView { background-color: %5; border: 1px solid %3; selection-background-color: %4; }
+        QPushButton { background-color: #3a3f4b; border: 1px solid %3; border-radius: 4px; padding: 3px 8px; }
+        QPushButton:hover { background-color: #4b5162; }
+    )").arg(bgColor, textColor, borderColor, highlightColor, secondaryBgColor);
+    this->setStyleSheet(styleSheet);
+}
+
+void WatchWidget::setupConnections()
+{
+    connect(m_addButton, &QPushButton::clicked, this, &WatchWidget::onAddClicked);
+    connect(m_fieldCombo->lineEdit(), &QLineEdit::returnPressed, this, &WatchWidget::onAddClicked);
+    connect(m_removeButton, &QPushButton::clicked, this, &WatchWidget::onRemoveClicked);
+    connect(m_clearLogButton, &QPushButton::clicked, this, &WatchWidget::onClearLogClicked);
+}
+
+void WatchWidget::onAddClicked()
+{
+    auto definition = parseWatchSpec(m_fieldCombo->currentText());
+    if (!definition) {
+        QMessageBox::warning(this, "Add Watch", "Enter a known field or a hex address with an optional type (i8, u8, i32, u32, i64, f32, f64).");
+        return;
+    }
+    WatchManager::instance().addWatch(*definition);
+    refreshWatches();
+}
+
+void WatchWidget::onRemoveClicked()
+{
+    int row = m_watchTable->currentRow();
+    if (row < 0) return;
+    QTableWidgetItem* item = m_watchTable->item(row, 0);
+    if (!item) return;
+    WatchManager::instance().removeWatch(item->data(Qt::UserRole).toULongLong());
+    refreshWatches();
+}
+
+void WatchWidget::onClearLogClicked()
+{
+    m_eventLog->clear();
+}
+
+void WatchWidget::refreshWatches()
+{
+    std::vector<WatchStats> allStats = WatchManager::instance().stats();
+
+    if (m_watchTable->rowCount() != static_cast<int>(allStats.size())) {
+        m_watchTable->setRowCount(static_cast<int>(allStats.size()));
+    }
+
+    auto setCell = [this](int row, int column, const QString& text) {
+        QTableWidgetItem* item = m_watchTable->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            m_watchTable->setItem(row, column, item);
+        }
+        if (item->text() != text) item->setText(text);
+        return item;
+    };
+
+    QHash<WatchId, QString> names;
+    for (int row = 0; row < static_cast<int>(allStats.size()); ++row) {
+        const WatchStats& stats = allStats[row];
+        names.insert(stats.id, stats.name);
+
+        setCell(row, 0, stats.name)->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(stats.id));
+        if (!stats.valid || stats.sampleCount == 0) {
+            setCell(row, 1, "N/A");
+            continue;
+        }
+        setCell(row, 1, QString::number(stats.last, 'g', 10));
+        setCell(row, 2, QString::number(stats.min, 'g', 10));
+        setCell(row, 3, QString::number(stats.max, 'g', 10));
+        setCell(row, 4, QString::number(stats.changeCount));
+        setCell(row, 5, QString::number(stats.changesPerSecond, 'f', 2));
+    }
+
+    for (const auto& event : WatchManager::instance().eventsSince(m_lastEventSequence)) {
+        m_lastEventSequence = event.sequence;
+        m_eventLog->appendPlainText(QString("[%1] %2: %3 -> %4 (frame %5)")
+            .arg(event.time, 0, 'f', 2)
+            .arg(names.value(event.id, QString::number(event.id)))
+            .arg(event.oldValue, 0, 'g', 10)
+            .arg(event.newValue, 0, 'g', 10)
+            .arg(event.frame));
+    }
+}
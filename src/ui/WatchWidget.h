@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QWidget>
+#include <QTimer>
+#include "Watches.h"
+
+class QTableWidget;
+class QComboBox;
+class QPushButton;
+class QPlainTextEdit;
+
+class WatchWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WatchWidget(QWidget* parent = nullptr);
+
+private slots:
+    void onAddClicked();
+    void onRemoveClicked();
+    void onClearLogClicked();
+    void refreshWatches();
+
+private:
+    void setupUi();
+    void applyStyling();
+    void setupConnections();
+
+    QComboBox* m_fieldCombo;
+    QPushButton* m_addButton;
+    QPushButton* m_removeButton;
+    QPushButton* m_clearLogButton;
+    QTableWidget* m_watchTable;
+    QPlainTextEdit* m_eventLog;
+
+    QTimer* m_refreshTimer;
+    uint64_t m_lastEventSequence = 0;
+};
@@ -0,0 +1,260 @@
+#include "AtlasIndex.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char CACHE_MAGIC[4] = { 'L', 'T', 'A', 'I' };
+    const quint16 CACHE_VERSION = 1;
+
+    // Lower is better: exact name, name prefix, name substring, map ID, comment only
+    int matchRank(const TeleportPoint& point, const QString& mapId, const QString& folded) {
+        const QString name = point.name.toCaseFolded();
+        if (name == folded) return 0;
+        if (name.startsWith(folded)) return 1;
+        if (name.contains(folded)) return 2;
+        if (mapId.toCaseFolded().contains(folded)) return 3;
+        return 4;
+    }
+}
+
+QString teleportPointId(const TeleportPoint& point)
+{
+    return QString("%1@%2,%3,%4")
+        .arg(point.name)
+        .arg(point.pos.x())
+        .arg(point.pos.y())
+        .arg(point.pos.z());
+}
+
+QList<TeleportPoint> parseTeleportPoints(const QJsonObject& mapData)
+{
+    QList<TeleportPoint> points;
+    QJsonObject pointNotes = mapData["pointNotes"].toObject();
+    auto parsePoint = [&pointNotes](const QJsonObject& pointObj, bool isUserDefined) {
+        TeleportPoint point;
+        point.name = pointObj["name"].toString();
+        const auto posObj = pointObj["pos"].toObject();
+        point.pos = QVector3D(posObj["x"].toDouble(), posObj["y"].toDouble(), posObj["z"].toDouble());
+        point.isUserDefined = isUserDefined;
+        point.comment = pointNotes.value(teleportPointId(point)).toString();
+        return point;
+    };
+
+    for (const QJsonValue& val : mapData["userPoints"].toArray()) {
+        points.append(parsePoint(val.toObject(), true));
+    }
+    for (const QJsonValue& val : mapData["gamePoints"].toArray()) {
+        points.append(parsePoint(val.toObject(), false));
+    }
+    return points;
+}
+
+AtlasIndex::AtlasIndex(QObject* parent)
+    : QObject(parent)
+{
+    // One worker keeps cache writes ordered behind the initial scan
+    m_pool.setMaxThreadCount(1);
+}
+
+AtlasIndex::~AtlasIndex()
+{
+    m_pool.waitForDone();
+}
+
+AtlasIndex::MapTable AtlasIndex::readCache(const QString& cachePath)
+{
+    MapTable maps;
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) return maps;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    char magic[4];
+    quint16 version = 0;
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) {
+        return maps;
+    }
+    stream >> version;
+    if (version != CACHE_VERSION) return maps;
+
+    quint32 mapCount = 0;
+    stream >> mapCount;
+    for (quint32 i = 0; i < mapCount && stream.status() == QDataStream::Ok; ++i) {
+        QString mapId;
+        MapEntry entry;
+        quint32 pointCount = 0;
+        stream >> mapId >> entry.lastModified >> entry.fileSize >> pointCount;
+        for (quint32 j = 0; j < pointCount && stream.status() == QDataStream::Ok; ++j) {
+            TeleportPoint point;
+            float x, y, z;
+            stream >> point.name >> x >> y >> z >> point.isUserDefined >> point.comment;
+            point.pos = QVector3D(x, y, z);
+            entry.points.append(point);
+        }
+        maps.insert(mapId, std::move(entry));
+    }
+
+    // A truncated cache is thrown away whole, every map gets re-parsed
+    if (stream.status() != QDataStream::Ok) return MapTable();
+    return maps;
+}
+
+bool AtlasIndex::writeCache(const QString& cachePath, const MapTable& maps)
+{
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream.writeRawData(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    stream << CACHE_VERSION << quint32(maps.size());
+    for (auto it = maps.cbegin(); it != maps.cend(); ++it) {
+        const MapEntry& entry = it.value();
+        stream << it.key() << entry.lastModified << entry.fileSize << quint32(entry.points.size());
+        for (const TeleportPoint& point : entry.points) {
+            stream << point.name << point.pos.x() << point.pos.y() << point.pos.z() << point.isUserDefined << point.comment;
+        }
+    }
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+AtlasIndex::MapTable AtlasIndex::scan(const QString& atlasDir, MapTable cached, bool* changed)
+{
+    MapTable maps;
+    *changed = false;
+
+    const QFileInfoList files = QDir(atlasDir).entryInfoList({ "*.json" }, QDir::Files);
+    for (const QFileInfo& fileInfo : files) {
+        const QString mapId = fileInfo.baseName();
+        const qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+        const qint64 fileSize = fileInfo.size();
+
+        auto it = cached.find(mapId);
+        if (it != cached.end() && it->lastModified == lastModified && it->fileSize == fileSize) {
+            maps.insert(mapId, std::move(it.value()));
+            continue;
+        }
+
+        QFile file(fileInfo.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) continue;
+
+        MapEntry entry;
+        entry.lastModified = lastModified;
+        entry.fileSize = fileSize;
+        entry.points = parseTeleportPoints(QJsonDocument::fromJson(file.readAll()).object());
+        maps.insert(mapId, std::move(entry));
+        *changed = true;
+    }
+
+    // Maps deleted since the cache was written
+    if (maps.size() != cached.size()) *changed = true;
+    return maps;
+}
+
+void AtlasIndex::load(const QString& atlasDir, const QString& cachePath)
+{
+    m_atlasDir = atlasDir;
+    m_cachePath = cachePath;
+
+    m_pool.start([this, atlasDir, cachePath]() {
+        bool changed = false;
+        MapTable maps = scan(atlasDir, readCache(cachePath), &changed);
+        if (changed && !writeCache(cachePath, maps)) {
+            qWarning() << "AtlasIndex: could not write" << cachePath;
+        }
+        QMetaObject::invokeMethod(this, [this, maps = std::move(maps)]() mutable {
+            publish(std::move(maps));
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AtlasIndex::publish(MapTable maps)
+{
+    // Maps saved while the scan was running are newer than what it read
+    for (auto it = m_maps.cbegin(); it != m_maps.cend(); ++it) {
+        maps.insert(it.key(), it.value());
+    }
+    m_maps = std::move(maps);
+    rebuildSearch();
+    m_ready = true;
+    qInfo() << "AtlasIndex: indexed" << m_entries.size() << "points across" << m_maps.size() << "maps";
+    emit ready();
+}
+
+void AtlasIndex::updateMap(const QString& mapId, const QList<TeleportPoint>& points)
+{
+    QFileInfo fileInfo(QString("%1/%2.json").arg(m_atlasDir, mapId));
+    MapEntry& entry = m_maps[mapId];
+    entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.fileSize = fileInfo.size();
+    entry.points = points;
+
+    // Until the first scan lands the cache is written by the scan itself
+    if (!m_ready) return;
+
+    rebuildSearch();
+    m_pool.start([cachePath = m_cachePath, maps = m_maps]() {
+        writeCache(cachePath, maps);
+    });
+}
+
+void AtlasIndex::rebuildSearch()
+{
+    m_entries.clear();
+    QStringList documents;
+    for (auto it = m_maps.cbegin(); it != m_maps.cend(); ++it) {
+        const QList<TeleportPoint>& points = it.value().points;
+        for (int i = 0; i < points.size(); ++i) {
+            m_entries.push_back(Entry{ it.key(), i });
+            documents.append(points[i].name + '\n' + points[i].comment + '\n' + it.key());
+        }
+    }
+    m_search.build(documents);
+}
+
+std::vector<AtlasSearchResult> AtlasIndex::search(const QString& query, int limit) const
+{
+    std::vector<AtlasSearchResult> results;
+    const QString folded = query.trimmed().toCaseFolded();
+    if (folded.isEmpty() || limit <= 0) return results;
+
+    struct Ranked {
+        int rank;
+        int entry;
+        const TeleportPoint* point;
+    };
+    std::vector<Ranked> ranked;
+    for (int index : m_search.search(folded)) {
+        const Entry& entry = m_entries[index];
+        const TeleportPoint& point = m_maps.constFind(entry.mapId)->points[entry.pointIndex];
+        ranked.push_back(Ranked{ matchRank(point, entry.mapId, folded), index, &point });
+    }
+
+    auto better = [](const Ranked& a, const Ranked& b) {
+        if (a.rank != b.rank) return a.rank < b.rank;
+        if (a.point->isUserDefined != b.point->isUserDefined) return a.point->isUserDefined;
+        if (a.point->name.size() != b.point->name.size()) return a.point->name.size() < b.point->name.size();
+        return a.entry < b.entry;
+    };
+    const size_t count = std::min(ranked.size(), size_t(limit));
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), better);
+
+    results.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        results.push_back(AtlasSearchResult{ m_entries[ranked[i].entry].mapId, *ranked[i].point });
+    }
+    return results;
+}
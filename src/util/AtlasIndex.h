@@ -0,0 +1,82 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVector3D>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <vector>
+#include "NgramIndex.h"
+
+struct TeleportPoint {
+    QString name;
+    QVector3D pos;
+    bool isUserDefined;
+    QString comment;
+};
+
+// Key used for a point's entry in a map file's "pointNotes"
+QString teleportPointId(const TeleportPoint& point);
+
+// userPoints then gamePoints of an atlas map file, with comments attached
+QList<TeleportPoint> parseTeleportPoints(const QJsonObject& mapData);
+
+struct AtlasSearchResult {
+    QString mapId;
+    TeleportPoint point;
+};
+
+// Search index over the points of every atlas map file. Built on a worker thread
+// from a persisted cache, re-parsing only the map files whose size or timestamp
+// changed since the cache was written.
+class AtlasIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AtlasIndex(QObject* parent = nullptr);
+    ~AtlasIndex();
+
+    void load(const QString& atlasDir, const QString& cachePath);
+    bool isReady() const { return m_ready; }
+
+    // Replaces one map's points after it was saved, and rewrites the cache
+    void updateMap(const QString& mapId, const QList<TeleportPoint>& points);
+
+    // Matches in names, comments and map IDs, best first
+    std::vector<AtlasSearchResult> search(const QString& query, int limit) const;
+
+signals:
+    void ready();
+
+private:
+    struct MapEntry {
+        qint64 lastModified = 0; // ms since epoch
+        qint64 fileSize = 0;
+        QList<TeleportPoint> points;
+    };
+    using MapTable = QHash<QString, MapEntry>;
+
+    static MapTable readCache(const QString& cachePath);
+    static bool writeCache(const QString& cachePath, const MapTable& maps);
+    static MapTable scan(const QString& atlasDir, MapTable cached, bool* changed);
+
+    void publish(MapTable maps);
+    void rebuildSearch();
+
+    QString m_atlasDir;
+    QString m_cachePath;
+    MapTable m_maps;
+    bool m_ready = false;
+
+    // Flattened for searching, in the order the documents were given to m_search
+    struct Entry {
+        QString mapId;
+        int pointIndex;
+    };
+    std::vector<Entry> m_entries;
+    NgramIndex m_search;
+
+    QThreadPool m_pool;
+};
@@ -0,0 +1,158 @@
+#include "CommandHistory.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // Older commands than this many distinct ones are left in the log but not loaded
+    constexpr int MAX_LOADED_ENTRIES = 50000;
+
+    QString escapeCommand(const QString& command) {
+        QString escaped;
+        escaped.reserve(command.size());
+        for (QChar c : command) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '\n') escaped += "\\n";
+            else if (c == '\r') escaped += "\\r";
+            else if (c == '\t') escaped += "\\t";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    QString unescapeCommand(const QString& escaped) {
+        QString command;
+        command.reserve(escaped.size());
+        for (qsizetype i = 0; i < escaped.size(); ++i) {
+            if (escaped[i] != '\\' || i + 1 == escaped.size()) {
+                command += escaped[i];
+                continue;
+            }
+            const QChar next = escaped[++i];
+            if (next == 'n') command += '\n';
+            else if (next == 'r') command += '\r';
+            else if (next == 't') command += '\t';
+            else command += next;
+        }
+        return command;
+    }
+}
+
+CommandHistory::CommandHistory(QObject* parent)
+    : QObject(parent),
+    m_sessionId(QString::number(QDateTime::currentMSecsSinceEpoch(), 36))
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+CommandHistory::~CommandHistory()
+{
+    m_pool.waitForDone();
+}
+
+void CommandHistory::load(const QString& filePath)
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // Only what was there before this session, our own appends are already in m_entries
+    const qint64 size = QFileInfo(filePath).size();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "CommandHistory: could not open" << filePath;
+    }
+
+    m_pool.start([this, filePath, size]() {
+        LoadedHistory history = readLog(filePath, size);
+        QMetaObject::invokeMethod(this, [this, history = std::move(history)]() mutable {
+            publish(std::move(history));
+        }, Qt::QueuedConnection);
+    });
+}
+
+CommandHistory::LoadedHistory CommandHistory::readLog(const QString& filePath, qint64 size)
+{
+    LoadedHistory history;
+    QFile file(filePath);
+    if (size <= 0 || !file.open(QIODevice::ReadOnly)) return history;
+
+    const QByteArray data = file.read(size);
+    const QList<QByteArray> lines = data.split('\n');
+
+    // Walked newest first, so the entry kept for a repeated command is its latest use
+    QSet<QString> seen;
+    std::vector<HistoryEntry> newestFirst;
+    for (auto it = lines.crbegin(); it != lines.crend() && int(newestFirst.size()) < MAX_LOADED_ENTRIES; ++it) {
+        QByteArray line = *it;
+        if (line.endsWith('\r')) line.chop(1);
+        const qsizetype tab = line.indexOf('\t');
+        if (tab < 0) continue;
+
+        HistoryEntry entry{ unescapeCommand(QString::fromUtf8(line.mid(tab + 1))), QString::fromUtf8(line.left(tab)) };
+        if (entry.command.isEmpty() || seen.contains(entry.command)) continue;
+        seen.insert(entry.command);
+        newestFirst.push_back(std::move(entry));
+    }
+    history.entries.assign(std::make_move_iterator(newestFirst.rbegin()), std::make_move_iterator(newestFirst.rend()));
+
+    QStringList documents;
+    documents.reserve(qsizetype(history.entries.size()));
+    for (const HistoryEntry& entry : history.entries) {
+        documents.append(entry.command);
+    }
+    history.index.build(documents);
+    return history;
+}
+
+void CommandHistory::publish(LoadedHistory history)
+{
+    const int count = int(history.entries.size());
+    m_entries.insert(m_entries.begin(), std::make_move_iterator(history.entries.begin()), std::make_move_iterator(history.entries.end()));
+    m_indexedCount = count;
+    m_index = std::move(history.index);
+    m_lastQuery.clear();
+    m_lastMatches.clear();
+    m_loaded = true;
+    qInfo() << "CommandHistory: loaded" << count << "commands";
+    emit loaded(count);
+}
+
+void CommandHistory::append(const QString& command)
+{
+    if (command.isEmpty()) return;
+    if (!m_entries.empty() && m_entries.back().command == command) return;
+
+    // Within the session a repeated command moves to the end instead of showing up twice
+    for (int i = m_indexedCount; i < int(m_entries.size()); ++i) {
+        if (m_entries[i].command == command) {
+            m_entries.erase(m_entries.begin() + i);
+            break;
+        }
+    }
+    m_entries.push_back(HistoryEntry{ command, m_sessionId });
+
+    if (m_file.isOpen()) {
+        m_file.write((m_sessionId + '\t' + escapeCommand(command) + '\n').toUtf8());
+        m_file.flush();
+    }
+}
+
+int CommandHistory::searchBackward(const QString& query, int before) const
+{
+    if (query.isEmpty()) return -1;
+    before = std::min(before, size());
+
+    for (int i = before - 1; i >= m_indexedCount; --i) {
+        if (m_entries[i].command.contains(query, Qt::CaseInsensitive)) return i;
+    }
+
+    if (query != m_lastQuery) {
+        m_lastQuery = query;
+        m_lastMatches = m_index.search(query);
+    }
+    const auto it = std::lower_bound(m_lastMatches.begin(), m_lastMatches.end(), std::min(before, m_indexedCount));
+    return it == m_lastMatches.begin() ? -1 : *(it - 1);
+}
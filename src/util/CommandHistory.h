@@ -0,0 +1,67 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QFile>
+#include <QThreadPool>
+#include <vector>
+#include "SuffixIndex.h"
+
+struct HistoryEntry {
+    QString command;
+    QString session; // Tag of the console session that entered it
+};
+
+// Console command history backed by an append-only log, one
+// "<session>\t<escaped command>" line per entry. The log is read and indexed on a
+// worker thread, keeping only the latest use of each command; until it lands the
+// history holds just this session's commands, and the older ones are put in
+// front of them once it does.
+class CommandHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CommandHistory(QObject* parent = nullptr);
+    ~CommandHistory();
+
+    void load(const QString& filePath);
+    bool isLoaded() const { return m_loaded; }
+
+    // Oldest first
+    int size() const { return int(m_entries.size()); }
+    const QString& at(int index) const { return m_entries[index].command; }
+    const QString& sessionId() const { return m_sessionId; }
+
+    void append(const QString& command);
+
+    // Newest entry before index `before` containing query, ignoring case, or -1
+    int searchBackward(const QString& query, int before) const;
+
+signals:
+    // count older entries were put in front of the history
+    void loaded(int count);
+
+private:
+    struct LoadedHistory {
+        std::vector<HistoryEntry> entries;
+        SuffixIndex index;
+    };
+
+    static LoadedHistory readLog(const QString& filePath, qint64 size);
+    void publish(LoadedHistory history);
+
+    QString m_sessionId;
+    QFile m_file;
+    bool m_loaded = false;
+
+    std::vector<HistoryEntry> m_entries;
+    // Entries before this are the loaded ones and covered by m_index, later ones are scanned
+    int m_indexedCount = 0;
+    SuffixIndex m_index;
+
+    // Matches for the last query, reused while Ctrl+R steps through them
+    mutable QString m_lastQuery;
+    mutable std::vector<int> m_lastMatches;
+
+    QThreadPool m_pool;
+};
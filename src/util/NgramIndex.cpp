@@ -0,0 +1,72 @@
+#include "NgramIndex.h"
+#include <algorithm>
+
+void NgramIndex::clear()
+{
+    m_documents.clear();
+    m_postings.clear();
+}
+
+void NgramIndex::build(const QStringList& documents)
+{
+    clear();
+    m_documents.reserve(documents.size());
+
+    for (int i = 0; i < documents.size(); ++i) {
+        QString folded = documents[i].toCaseFolded();
+        const QChar* chars = folded.constData();
+        for (qsizetype j = 0; j + 3 <= folded.size(); ++j) {
+            std::vector<int>& posting = m_postings[trigramKey(chars + j)];
+            // Documents are added in order, so checking the tail keeps each list unique and sorted
+            if (posting.empty() || posting.back() != i) {
+                posting.push_back(i);
+            }
+        }
+        m_documents.append(std::move(folded));
+    }
+}
+
+std::vector<int> NgramIndex::search(const QString& query) const
+{
+    std::vector<int> result;
+    const QString folded = query.toCaseFolded();
+
+    if (folded.size() < 3) {
+        // Too short for a trigram, the folded documents are still cheaper to scan than the originals
+        for (int i = 0; i < m_documents.size(); ++i) {
+            if (m_documents[i].contains(folded)) result.push_back(i);
+        }
+        return result;
+    }
+
+    std::vector<const std::vector<int>*> postings;
+    const QChar* chars = folded.constData();
+    for (qsizetype j = 0; j + 3 <= folded.size(); ++j) {
+        auto it = m_postings.constFind(trigramKey(chars + j));
+        if (it == m_postings.cend()) return result;
+        postings.push_back(&it.value());
+    }
+
+    // Intersect smallest first so the candidate set shrinks as fast as possible
+    std::sort(postings.begin(), postings.end(), [](const auto* a, const auto* b) {
+        return a->size() != b->size() ? a->size() < b->size() : a < b;
+    });
+    postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+
+    std::vector<int> candidates = *postings.front();
+    std::vector<int> scratch;
+    for (size_t p = 1; p < postings.size() && !candidates.empty(); ++p) {
+        scratch.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), postings[p]->begin(), postings[p]->end(), std::back_inserter(scratch));
+        candidates.swap(scratch);
+    }
+
+    // Sharing every trigram doesn't mean they appear in order
+    result.reserve(candidates.size());
+    for (int index : candidates) {
+        if (folded.size() == 3 || m_documents[index].contains(folded)) {
+            result.push_back(index);
+        }
+    }
+    return result;
+}
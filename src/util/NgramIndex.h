@@ -0,0 +1,29 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <vector>
+
+// Trigram index for case-insensitive substring search over a fixed set of
+// documents. Candidates come from intersecting the posting lists of the
+// query's trigrams and are then verified, so results are exact.
+class NgramIndex
+{
+public:
+    void build(const QStringList& documents);
+    void clear();
+
+    bool isEmpty() const { return m_documents.isEmpty(); }
+    qsizetype size() const { return m_documents.size(); }
+
+    // Indices of documents containing query, ascending. An empty query matches everything
+    std::vector<int> search(const QString& query) const;
+
+private:
+    static quint64 trigramKey(const QChar* chars) {
+        return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | chars[2].unicode();
+    }
+
+    QStringList m_documents; // Case folded
+    QHash<quint64, std::vector<int>> m_postings; // Ascending document indices
+};
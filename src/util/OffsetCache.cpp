@@ -0,0 +1,104 @@
+#include "OffsetCache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+OffsetCache::OffsetCache(const QString& filePath, uint64_t imageHash)
+    : m_filePath(filePath), m_imageHash(imageHash)
+{
+    load();
+}
+
+void OffsetCache::load()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    bool ok = false;
+    uint64_t storedHash = root["imageHash"].toString().toULongLong(&ok, 16);
+    if (!ok || storedHash != m_imageHash) {
+        qInfo() << "OffsetCache: Executable changed, discarding" << m_filePath;
+        m_dirty = true;
+        return;
+    }
+
+    QJsonObject offsets = root["offsets"].toObject();
+    for (auto it = offsets.begin(); it != offsets.end(); ++it) {
+        uintptr_t rva = it.value().toString().toULongLong(&ok, 16);
+        if (ok) {
+            m_offsets.insert(it.key(), rva);
+        }
+    }
+
+    QJsonObject bytes = root["bytes"].toObject();
+    for (auto it = bytes.begin(); it != bytes.end(); ++it) {
+        m_bytes.insert(it.key(), QByteArray::fromHex(it.value().toString().toLatin1()));
+    }
+}
+
+std::optional<uintptr_t> OffsetCache::lookup(const QString& key) const
+{
+    auto it = m_offsets.constFind(key);
+    if (it == m_offsets.constEnd()) return std::nullopt;
+    return it.value();
+}
+
+void OffsetCache::store(const QString& key, uintptr_t rva)
+{
+    auto it = m_offsets.find(key);
+    if (it != m_offsets.end() && it.value() == rva) return;
+    m_offsets.insert(key, rva);
+    m_dirty = true;
+}
+
+std::optional<QByteArray> OffsetCache::lookupBytes(const QString& key) const
+{
+    auto it = m_bytes.constFind(key);
+    if (it == m_bytes.constEnd()) return std::nullopt;
+    return it.value();
+}
+
+void OffsetCache::storeBytes(const QString& key, const QByteArray& bytes)
+{
+    auto it = m_bytes.find(key);
+    if (it != m_bytes.end() && it.value() == bytes) return;
+    m_bytes.insert(key, bytes);
+    m_dirty = true;
+}
+
+bool OffsetCache::save()
+{
+    if (!m_dirty) return true;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "OffsetCache: Could not write" << m_filePath;
+        return false;
+    }
+
+    QJsonObject offsets;
+    for (auto it = m_offsets.constBegin(); it != m_offsets.constEnd(); ++it) {
+        offsets[it.key()] = QString::number(it.value(), 16);
+    }
+
+    QJsonObject bytes;
+    for (auto it = m_bytes.constBegin(); it != m_bytes.constEnd(); ++it) {
+        bytes[it.key()] = QString::fromLatin1(it.value().toHex());
+    }
+
+    QJsonObject root;
+    root["imageHash"] = QString::number(m_imageHash, 16);
+    root["offsets"] = offsets;
+    root["bytes"] = bytes;
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    m_dirty = false;
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <optional>
+#include <cstdint>
+
+// Resolved RVAs persisted between runs, plus byte blobs read from the image
+// such as the original code under a patch site. The whole cache is dropped when
+// the image hash changes, so a game update forces a fresh scan.
+class OffsetCache
+{
+public:
+    OffsetCache(const QString& filePath, uint64_t imageHash);
+
+    std::optional<uintptr_t> lookup(const QString& key) const;
+    void store(const QString& key, uintptr_t rva);
+
+    std::optional<QByteArray> lookupBytes(const QString& key) const;
+    void storeBytes(const QString& key, const QByteArray& bytes);
+
+    // Writes the file back if anything was stored since loading
+    bool save();
+
+private:
+    void load();
+
+    QString m_filePath;
+    uint64_t m_imageHash;
+    QHash<QString, uintptr_t> m_offsets;
+    QHash<QString, QByteArray> m_bytes;
+    bool m_dirty = false;
+};
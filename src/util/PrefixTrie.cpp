@@ -0,0 +1,82 @@
+#include "PrefixTrie.h"
+#include <algorithm>
+#include <queue>
+
+void PrefixTrie::clear()
+{
+    m_words.clear();
+    m_nodes.clear();
+    m_edges.clear();
+}
+
+void PrefixTrie::build(std::vector<std::string> words)
+{
+    clear();
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    m_words = std::move(words);
+
+    struct Pending {
+        int node;
+        size_t depth;
+    };
+
+    // Breadth first, so all children of a node are appended to m_edges in one go
+    m_nodes.push_back(Node{ 0, int(m_words.size()), 0, 0 });
+    std::queue<Pending> pending;
+    pending.push(Pending{ 0, 0 });
+
+    while (!pending.empty()) {
+        const Pending current = pending.front();
+        pending.pop();
+
+        int i = m_nodes[current.node].first;
+        const int last = m_nodes[current.node].last;
+
+        // A word ending at this node sorts before every word that continues past it
+        while (i < last && m_words[i].size() == current.depth) ++i;
+
+        m_nodes[current.node].childBegin = int(m_edges.size());
+        while (i < last) {
+            const char label = m_words[i][current.depth];
+            int j = i + 1;
+            while (j < last && m_words[j][current.depth] == label) ++j;
+
+            const int child = int(m_nodes.size());
+            m_nodes.push_back(Node{ i, j, 0, 0 });
+            m_edges.push_back(Edge{ label, child });
+            pending.push(Pending{ child, current.depth + 1 });
+            i = j;
+        }
+        m_nodes[current.node].childCount = int(m_edges.size()) - m_nodes[current.node].childBegin;
+    }
+}
+
+PrefixTrie::Range PrefixTrie::find(std::string_view prefix) const
+{
+    if (m_nodes.empty()) return Range();
+
+    int node = 0;
+    for (char c : prefix) {
+        const auto begin = m_edges.begin() + m_nodes[node].childBegin;
+        const auto end = begin + m_nodes[node].childCount;
+        const auto it = std::lower_bound(begin, end, c, [](const Edge& edge, char label) {
+            return static_cast<unsigned char>(edge.label) < static_cast<unsigned char>(label);
+        });
+        if (it == end || it->label != c) return Range();
+        node = it->node;
+    }
+    return Range{ m_nodes[node].first, m_nodes[node].last };
+}
+
+std::string_view PrefixTrie::commonPrefix(Range range) const
+{
+    if (range.isEmpty()) return std::string_view();
+
+    // The words are sorted, so the first and last of the range bound what they all share
+    const std::string& first = m_words[range.begin];
+    const std::string& last = m_words[range.end - 1];
+    size_t length = 0;
+    while (length < first.size() && length < last.size() && first[length] == last[length]) ++length;
+    return std::string_view(first).substr(0, length);
+}
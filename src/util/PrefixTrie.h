@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Prefix trie over a fixed word list. Every node records the range of the sorted
+// word list below it, so a lookup costs one step per prefix character and the
+// matching words come back as a contiguous, already sorted range.
+class PrefixTrie
+{
+public:
+    struct Range {
+        int begin = 0;
+        int end = 0;
+
+        bool isEmpty() const { return begin >= end; }
+        int size() const { return end - begin; }
+    };
+
+    // Duplicates are dropped
+    void build(std::vector<std::string> words);
+    void clear();
+
+    bool isEmpty() const { return m_words.empty(); }
+    size_t size() const { return m_words.size(); }
+    const std::string& word(int index) const { return m_words[index]; }
+
+    // Indices of the words starting with prefix
+    Range find(std::string_view prefix) const;
+
+    // Longest prefix shared by every word in range
+    std::string_view commonPrefix(Range range) const;
+
+private:
+    struct Node {
+        int first;
+        int last;
+        int childBegin;
+        int childCount;
+    };
+    struct Edge {
+        char label;
+        int node;
+    };
+
+    std::vector<std::string> m_words; // Sorted
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges; // Each node's children are contiguous and sorted by label
+};
@@ -0,0 +1,160 @@
+#include "QuadTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int LEAF_SIZE = 8;
+    // Stops runaway splitting when many points share a position
+    constexpr int MAX_DEPTH = 16;
+
+    qreal distanceSquaredToRect(const QPointF& p, const QRectF& rect) {
+        qreal dx = std::max({ rect.left() - p.x(), 0.0, p.x() - rect.right() });
+        qreal dy = std::max({ rect.top() - p.y(), 0.0, p.y() - rect.bottom() });
+        return dx * dx + dy * dy;
+    }
+}
+
+void QuadTree::clear()
+{
+    m_points.clear();
+    m_order.clear();
+    m_nodes.clear();
+}
+
+void QuadTree::build(const std::vector<QPointF>& points)
+{
+    clear();
+    m_points = points;
+    if (m_points.empty()) return;
+
+    qreal left = m_points[0].x(), right = left, top = m_points[0].y(), bottom = top;
+    m_order.resize(m_points.size());
+    for (size_t i = 0; i < m_points.size(); ++i) {
+        m_order[i] = static_cast<int>(i);
+        left = std::min(left, m_points[i].x());
+        right = std::max(right, m_points[i].x());
+        top = std::min(top, m_points[i].y());
+        bottom = std::max(bottom, m_points[i].y());
+    }
+
+    // Square root node so every level splits both axes evenly
+    qreal side = std::max({ right - left, bottom - top, 1.0 });
+    m_nodes.reserve(4 * m_points.size() / LEAF_SIZE + 1);
+    buildNode(QRectF(left, top, side, side), 0, static_cast<int>(m_order.size()), 0);
+}
+
+int QuadTree::buildNode(const QRectF& bounds, int begin, int end, int depth)
+{
+    int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(Node{ bounds, begin, end });
+
+    if (end - begin <= LEAF_SIZE || depth >= MAX_DEPTH) {
+        return nodeIndex;
+    }
+
+    // Partition into quadrants in place: split on y, then each half on x
+    const QPointF center = bounds.center();
+    auto first = m_order.begin() + begin;
+    auto last = m_order.begin() + end;
+    auto midY = std::partition(first, last, [this, &center](int i) { return m_points[i].y() < center.y(); });
+    auto midTop = std::partition(first, midY, [this, &center](int i) { return m_points[i].x() < center.x(); });
+    auto midBottom = std::partition(midY, last, [this, &center](int i) { return m_points[i].x() < center.x(); });
+
+    const int splits[5] = {
+        begin,
+        static_cast<int>(midTop - m_order.begin()),
+        static_cast<int>(midY - m_order.begin()),
+        static_cast<int>(midBottom - m_order.begin()),
+        end
+    };
+    const qreal half = bounds.width() / 2.0;
+    const QRectF quadrants[4] = {
+        QRectF(bounds.left(), bounds.top(), half, half),
+        QRectF(center.x(), bounds.top(), half, half),
+        QRectF(bounds.left(), center.y(), half, half),
+        QRectF(center.x(), center.y(), half, half)
+    };
+
+    for (int q = 0; q < 4; ++q) {
+        if (splits[q] == splits[q + 1]) continue;
+        int child = buildNode(quadrants[q], splits[q], splits[q + 1], depth + 1);
+        m_nodes[nodeIndex].children[q] = child;
+    }
+    return nodeIndex;
+}
+
+int QuadTree::nearest(const QPointF& origin, qreal maxDistance) const
+{
+    if (m_nodes.empty() || maxDistance < 0.0) return -1;
+
+    int bestIndex = -1;
+    qreal bestDist = maxDistance * maxDistance;
+
+    std::vector<int> stack = { 0 };
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (distanceSquaredToRect(origin, node.bounds) > bestDist) continue;
+
+        if (node.isLeaf()) {
+            for (int i = node.begin; i < node.end; ++i) {
+                int idx = m_order[i];
+                QPointF delta = m_points[idx] - origin;
+                qreal dist = QPointF::dotProduct(delta, delta);
+                if (dist <= bestDist) {
+                    bestDist = dist;
+                    bestIndex = idx;
+                }
+            }
+            continue;
+        }
+
+        // Farthest pushed first so the closest quadrant is searched first and tightens the bound
+        std::pair<qreal, int> children[4];
+        int childCount = 0;
+        for (int child : node.children) {
+            if (child == -1) continue;
+            std::pair<qreal, int> entry{ distanceSquaredToRect(origin, m_nodes[child].bounds), child };
+            int slot = childCount++;
+            for (; slot > 0 && children[slot - 1].first < entry.first; --slot) {
+                children[slot] = children[slot - 1];
+            }
+            children[slot] = entry;
+        }
+        for (int i = 0; i < childCount; ++i) {
+            stack.push_back(children[i].second);
+        }
+    }
+    return bestIndex;
+}
+
+std::vector<int> QuadTree::withinRect(const QRectF& rect) const
+{
+    std::vector<int> result;
+    if (m_nodes.empty()) return result;
+
+    std::vector<int> stack = { 0 };
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        // Compared by hand, QRectF::intersects ignores zero-size rects
+        if (node.bounds.left() > rect.right() || node.bounds.right() < rect.left() ||
+            node.bounds.top() > rect.bottom() || node.bounds.bottom() < rect.top()) continue;
+
+        if (node.isLeaf()) {
+            for (int i = node.begin; i < node.end; ++i) {
+                int idx = m_order[i];
+                const QPointF& p = m_points[idx];
+                if (p.x() >= rect.left() && p.x() <= rect.right() && p.y() >= rect.top() && p.y() <= rect.bottom()) {
+                    result.push_back(idx);
+                }
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child != -1) stack.push_back(child);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <QPointF>
+#include <QRectF>
+#include <vector>
+
+// Static quadtree over a snapshot of 2D points, built once and queried by index
+// into the point list it was built from. Used for picking markers on the map.
+class QuadTree
+{
+public:
+    void build(const std::vector<QPointF>& points);
+    void clear();
+
+    bool isEmpty() const { return m_points.empty(); }
+    size_t size() const { return m_points.size(); }
+    const QPointF& point(int index) const { return m_points[index]; }
+
+    // Index of the closest point within maxDistance, or -1
+    int nearest(const QPointF& origin, qreal maxDistance) const;
+
+    // Indices of all points inside rect, in no particular order
+    std::vector<int> withinRect(const QRectF& rect) const;
+
+private:
+    struct Node {
+        QRectF bounds;
+        int begin;
+        int end;
+        int children[4] = { -1, -1, -1, -1 };
+        bool isLeaf() const { return children[0] == -1 && children[1] == -1 && children[2] == -1 && children[3] == -1; }
+    };
+
+    int buildNode(const QRectF& bounds, int begin, int end, int depth);
+
+    std::vector<QPointF> m_points;
+    std::vector<int> m_order;
+    std::vector<Node> m_nodes;
+};
@@ -0,0 +1,25 @@
+#include "SignatureBatch.h"
+#include "OffsetCache.h"
+#include <algorithm>
+
+void SignatureBatch::add(const OffsetCache& cache, const QString& key, Signature signature, Resolve resolve)
+{
+    if (cache.lookup(key)) return;
+    if (std::any_of(m_requests.begin(), m_requests.end(), [&](const Request& request) { return request.key == key; })) return;
+
+    m_signatures.push_back(std::move(signature));
+    m_requests.push_back(Request{ key, std::move(resolve) });
+}
+
+void SignatureBatch::run(uintptr_t imageBase, OffsetCache& cache)
+{
+    auto matches = findSignaturesInImage(imageBase, m_signatures);
+    for (size_t i = 0; i < matches.size(); ++i) {
+        if (!matches[i]) continue;
+        const Request& request = m_requests[i];
+        cache.store(request.key, request.resolve ? request.resolve(*matches[i]) : *matches[i]);
+    }
+
+    m_signatures.clear();
+    m_requests.clear();
+}
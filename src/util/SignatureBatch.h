@@ -0,0 +1,32 @@
+#pragma once
+#include "SignatureScanner.h"
+#include <QString>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+class OffsetCache;
+
+// Signatures from several owners resolved in a single pass over the image.
+// Owners queue what their offset cache entries are missing, run() scans once
+// and stores every match under its key, where the owners read it back.
+class SignatureBatch
+{
+public:
+    // Turns the RVA of a match into the RVA to store
+    using Resolve = std::function<uintptr_t(uintptr_t matchRva)>;
+
+    // Does nothing if the key is cached or already queued
+    void add(const OffsetCache& cache, const QString& key, Signature signature, Resolve resolve);
+
+    void run(uintptr_t imageBase, OffsetCache& cache);
+
+private:
+    struct Request {
+        QString key;
+        Resolve resolve;
+    };
+
+    std::vector<Signature> m_signatures;
+    std::vector<Request> m_requests;
+};
@@ -0,0 +1,348 @@
+#include "SignatureScanner.h"
+#include <cstring>
+#include <charconv>
+#include <bit>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LTCON_SCANNER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LTCON_TARGET_AVX2
+#else
+#define LTCON_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+std::optional<Signature> parseSignature(const std::string& text)
+{
+    Signature signature;
+    size_t i = 0;
+    while (i < text.size()) {
+        if (text[i] == ' ') {
+            ++i;
+            continue;
+        }
+        if (text[i] == '?') {
+            signature.bytes.push_back(0);
+            signature.mask.push_back(0x00);
+            i += (i + 1 < text.size() && text[i + 1] == '?') ? 2 : 1;
+            continue;
+        }
+        if (i + 1 >= text.size()) return std::nullopt;
+
+        uint8_t value = 0;
+        auto result = std::from_chars(text.data() + i, text.data() + i + 2, value, 16);
+        if (result.ec != std::errc() || result.ptr != text.data() + i + 2) return std::nullopt;
+
+        signature.bytes.push_back(value);
+        signature.mask.push_back(0xFF);
+        i += 2;
+    }
+
+    if (signature.bytes.empty()) return std::nullopt;
+    return signature;
+}
+
+std::optional<size_t> findSignature(std::span<const uint8_t> data, const Signature& signature)
+{
+    const size_t length = signature.size();
+    if (length == 0 || data.size() < length) return std::nullopt;
+
+    // Anchor on the first concrete byte so memchr does the bulk of the skipping
+    size_t anchor = 0;
+    while (anchor < length && signature.mask[anchor] == 0) ++anchor;
+    if (anchor == length) return 0;
+
+    const uint8_t* base = data.data();
+    const uint8_t* cursor = base + anchor;
+    const uint8_t* last = base + data.size() - length + anchor;
+
+    while (cursor <= last) {
+        cursor = static_cast<const uint8_t*>(std::memchr(cursor, signature.bytes[anchor], last - cursor + 1));
+        if (!cursor) break;
+
+        const uint8_t* candidate = cursor - anchor;
+        size_t j = 0;
+        for (; j < length; ++j) {
+            if ((candidate[j] & signature.mask[j]) != signature.bytes[j]) break;
+        }
+        if (j == length) return static_cast<size_t>(candidate - base);
+        ++cursor;
+    }
+    return std::nullopt;
+}
+
+namespace {
+
+    // Each signature is prefiltered on two concrete bytes, compared against a whole
+    // register of candidate start positions at once. Everything else is verified per candidate
+    struct CompiledSignature {
+        const Signature* signature;
+        size_t firstAnchor;
+        size_t secondAnchor;
+        bool resolved = false;
+    };
+
+    // Rough frequency in x64 code, lower is rarer. Rare anchors mean fewer candidates to verify
+    int byteCommonness(uint8_t value) {
+        switch (value) {
+        case 0x00: case 0xFF: case 0xCC: return 4;
+        case 0x48: case 0x8B: case 0x89: case 0x90: case 0x0F: return 3;
+        case 0x4C: case 0x44: case 0xE8: case 0x24: case 0x83: return 2;
+        default: return 0;
+        }
+    }
+
+    CompiledSignature compile(const Signature& signature) {
+        std::vector<size_t> concrete;
+        for (size_t i = 0; i < signature.size(); ++i) {
+            if (signature.mask[i]) concrete.push_back(i);
+        }
+
+        std::stable_sort(concrete.begin(), concrete.end(), [&](size_t a, size_t b) {
+            return byteCommonness(signature.bytes[a]) < byteCommonness(signature.bytes[b]);
+        });
+
+        CompiledSignature compiled{ &signature, 0, 0 };
+        if (!concrete.empty()) {
+            compiled.firstAnchor = concrete[0];
+            compiled.secondAnchor = concrete.size() > 1 ? concrete[1] : concrete[0];
+        }
+        return compiled;
+    }
+
+    bool matchesAt(const uint8_t* candidate, const Signature& signature) {
+        for (size_t j = 0; j < signature.size(); ++j) {
+            if ((candidate[j] & signature.mask[j]) != signature.bytes[j]) return false;
+        }
+        return true;
+    }
+
+    // Walks candidate bits lowest first so the earliest match wins
+    bool resolveCandidates(uint32_t candidates, const uint8_t* base, size_t position,
+        CompiledSignature& compiled, std::optional<size_t>& result) {
+        while (candidates) {
+            size_t start = position + std::countr_zero(candidates);
+            if (matchesAt(base + start, *compiled.signature)) {
+                result = start;
+                compiled.resolved = true;
+                return true;
+            }
+            candidates &= candidates - 1;
+        }
+        return false;
+    }
+
+#ifdef LTCON_SCANNER_X86
+    bool cpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    LTCON_TARGET_AVX2
+    size_t scanAvx2(const uint8_t* base, size_t limit, std::vector<CompiledSignature>& compiled,
+        std::vector<std::optional<size_t>>& results, size_t& remaining) {
+        size_t position = 0;
+        for (; position + 32 <= limit && remaining > 0; position += 32) {
+            for (size_t s = 0; s < compiled.size(); ++s) {
+                auto& sig = compiled[s];
+                if (sig.resolved) continue;
+
+                __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + position + sig.firstAnchor));
+                __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + position + sig.secondAnchor));
+                __m256i hits = _mm256_and_si256(
+                    _mm256_cmpeq_epi8(first, _mm256_set1_epi8(static_cast<char>(sig.signature->bytes[sig.firstAnchor]))),
+                    _mm256_cmpeq_epi8(second, _mm256_set1_epi8(static_cast<char>(sig.signature->bytes[sig.secondAnchor]))));
+
+                uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+                if (candidates && resolveCandidates(candidates, base, position, sig, results[s])) {
+                    --remaining;
+                }
+            }
+        }
+        return position;
+    }
+
+    size_t scanSse2(const uint8_t* base, size_t limit, std::vector<CompiledSignature>& compiled,
+        std::vector<std::optional<size_t>>& results, size_t& remaining) {
+        size_t position = 0;
+        for (; position + 16 <= limit && remaining > 0; position += 16) {
+            for (size_t s = 0; s < compiled.size(); ++s) {
+                auto& sig = compiled[s];
+                if (sig.resolved) continue;
+
+                __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + position + sig.firstAnchor));
+                __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + position + sig.secondAnchor));
+                __m128i hits = _mm_and_si128(
+                    _mm_cmpeq_epi8(first, _mm_set1_epi8(static_cast<char>(sig.signature->bytes[sig.firstAnchor]))),
+                    _mm_cmpeq_epi8(second, _mm_set1_epi8(static_cast<char>(sig.signature->bytes[sig.secondAnchor]))));
+
+                uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+                if (candidates && resolveCandidates(candidates, base, position, sig, results[s])) {
+                    --remaining;
+                }
+            }
+        }
+        return position;
+    }
+#endif
+}
+
+std::vector<std::optional<size_t>> findSignatures(std::span<const uint8_t> data, std::span<const Signature> signatures)
+{
+    std::vector<std::optional<size_t>> results(signatures.size());
+
+    std::vector<CompiledSignature> compiled;
+    compiled.reserve(signatures.size());
+    size_t longest = 0;
+    size_t remaining = 0;
+    for (const auto& signature : signatures) {
+        compiled.push_back(compile(signature));
+        if (signature.size() == 0 || signature.size() > data.size()) {
+            compiled.back().resolved = true;
+            continue;
+        }
+        if (std::all_of(signature.mask.begin(), signature.mask.end(), [](uint8_t m) { return m == 0; })) {
+            results[compiled.size() - 1] = 0;
+            compiled.back().resolved = true;
+            continue;
+        }
+        longest = std::max(longest, signature.size());
+        ++remaining;
+    }
+
+    // Vector blocks stop once a block could read past the end for the longest
+    // signature. The tail is finished with the scalar matcher from that point on
+    size_t vectorLimit = data.size() >= longest ? data.size() - longest + 1 : 0;
+    size_t position = 0;
+
+#ifdef LTCON_SCANNER_X86
+    static const bool s_hasAvx2 = cpuHasAvx2();
+    if (remaining > 0) {
+        position = s_hasAvx2
+            ? scanAvx2(data.data(), vectorLimit, compiled, results, remaining)
+            : scanSse2(data.data(), vectorLimit, compiled, results, remaining);
+    }
+#endif
+
+    for (size_t s = 0; s < compiled.size() && remaining > 0; ++s) {
+        if (compiled[s].resolved) continue;
+        if (auto match = findSignature(data.subspan(position), signatures[s])) {
+            results[s] = position + *match;
+            --remaining;
+        }
+        compiled[s].resolved = true;
+    }
+
+    return results;
+}
+
+std::vector<std::optional<uintptr_t>> findSignaturesInImage(uintptr_t imageBase, std::span<const Signature> signatures)
+{
+    std::vector<std::optional<uintptr_t>> rvas(signatures.size());
+    if (signatures.empty()) return rvas;
+
+    for (const auto& section : getExecutableSections(imageBase)) {
+        std::vector<Signature> pending;
+        std::vector<size_t> pendingIndex;
+        for (size_t i = 0; i < signatures.size(); ++i) {
+            if (!rvas[i]) {
+                pending.push_back(signatures[i]);
+                pendingIndex.push_back(i);
+            }
+        }
+        if (pending.empty()) break;
+
+        std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(section.start), section.size);
+        auto matches = findSignatures(data, pending);
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (matches[i]) {
+                rvas[pendingIndex[i]] = section.start - imageBase + *matches[i];
+            }
+        }
+    }
+    return rvas;
+}
+
+#ifdef _WIN32
+std::vector<ImageSection> getExecutableSections(uintptr_t imageBase)
+{
+    std::vector<ImageSection> sections;
+    if (!imageBase) return sections;
+
+    auto* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(imageBase);
+    if (dos->e_magic != IMAGE_DOS_SIGNATURE) return sections;
+    auto* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(imageBase + dos->e_lfanew);
+    if (nt->Signature != IMAGE_NT_SIGNATURE) return sections;
+
+    const IMAGE_SECTION_HEADER* section = IMAGE_FIRST_SECTION(nt);
+    for (WORD i = 0; i < nt->FileHeader.NumberOfSections; ++i, ++section) {
+        if (section->Characteristics & IMAGE_SCN_MEM_EXECUTE) {
+            sections.push_back({ imageBase + section->VirtualAddress, section->Misc.VirtualSize });
+        }
+    }
+    return sections;
+}
+
+std::vector<ImageSection> getReadOnlyDataSections(uintptr_t imageBase)
+{
+    std::vector<ImageSection> sections;
+    if (!imageBase) return sections;
+
+    auto* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(imageBase);
+    if (dos->e_magic != IMAGE_DOS_SIGNATURE) return sections;
+    auto* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(imageBase + dos->e_lfanew);
+    if (nt->Signature != IMAGE_NT_SIGNATURE) return sections;
+
+    const IMAGE_SECTION_HEADER* section = IMAGE_FIRST_SECTION(nt);
+    for (WORD i = 0; i < nt->FileHeader.NumberOfSections; ++i, ++section) {
+        const DWORD flags = section->Characteristics;
+        if ((flags & IMAGE_SCN_CNT_INITIALIZED_DATA) && (flags & IMAGE_SCN_MEM_READ) &&
+            !(flags & (IMAGE_SCN_MEM_WRITE | IMAGE_SCN_MEM_EXECUTE))) {
+            sections.push_back({ imageBase + section->VirtualAddress, section->Misc.VirtualSize });
+        }
+    }
+    return sections;
+}
+
+uint64_t hashImageHeaders(uintptr_t imageBase)
+{
+    if (!imageBase) return 0;
+
+    auto* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(imageBase);
+    if (dos->e_magic != IMAGE_DOS_SIGNATURE) return 0;
+    auto* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(imageBase + dos->e_lfanew);
+    if (nt->Signature != IMAGE_NT_SIGNATURE) return 0;
+
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto* bytes = reinterpret_cast<const uint8_t*>(imageBase);
+    for (DWORD i = 0; i < nt->OptionalHeader.SizeOfHeaders; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+#else
+std::vector<ImageSection> getExecutableSections(uintptr_t) { return {}; }
+std::vector<ImageSection> getReadOnlyDataSections(uintptr_t) { return {}; }
+uint64_t hashImageHeaders(uintptr_t) { return 0; }
+#endif
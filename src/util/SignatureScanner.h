@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <span>
+#include <optional>
+#include <cstdint>
+
+// Byte pattern with wildcards, written as "48 8B 05 ?? ?? ?? ?? 84 C0"
+struct Signature {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> mask; // 0xFF for bytes that must match, 0x00 for wildcards
+
+    size_t size() const { return bytes.size(); }
+};
+
+std::optional<Signature> parseSignature(const std::string& text);
+
+// Offset of the first match in data
+std::optional<size_t> findSignature(std::span<const uint8_t> data, const Signature& signature);
+
+// First match of every signature, found in a single pass over data.
+// Uses AVX2 or SSE2 when the CPU has them, results are identical either way
+std::vector<std::optional<size_t>> findSignatures(std::span<const uint8_t> data, std::span<const Signature> signatures);
+
+struct ImageSection {
+    uintptr_t start;
+    size_t size;
+};
+
+// Executable sections of a PE image already mapped at imageBase
+std::vector<ImageSection> getExecutableSections(uintptr_t imageBase);
+
+// Initialized read-only data sections of a PE image, where its string literals live
+std::vector<ImageSection> getReadOnlyDataSections(uintptr_t imageBase);
+
+// RVA of the first match of each signature across the image's executable sections
+std::vector<std::optional<uintptr_t>> findSignaturesInImage(uintptr_t imageBase, std::span<const Signature> signatures);
+
+// Cheap identity for a PE image: hashes the mapped headers, which carry the
+// link timestamp, checksum and section layout, so it changes on every game update
+uint64_t hashImageHeaders(uintptr_t imageBase);
@@ -0,0 +1,205 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <queue>
+#include <cmath>
+
+namespace {
+    constexpr int LEAF_SIZE = 8;
+
+    float distanceSquaredToBox(const QVector3D& p, const QVector3D& min, const QVector3D& max) {
+        float dist = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            float v = p[axis];
+            if (v < min[axis]) dist += (min[axis] - v) * (min[axis] - v);
+            else if (v > max[axis]) dist += (v - max[axis]) * (v - max[axis]);
+        }
+        return dist;
+    }
+
+    // Distance from p to the segment, and how far along the segment the closest point lies
+    float distanceToSegment(const QVector3D& p, const QVector3D& origin, const QVector3D& direction, float length, float* along) {
+        float t = std::clamp(QVector3D::dotProduct(p - origin, direction), 0.0f, length);
+        if (along) *along = t;
+        return (origin + direction * t).distanceToPoint(p);
+    }
+}
+
+void SpatialIndex::clear()
+{
+    m_points.clear();
+    m_order.clear();
+    m_nodes.clear();
+}
+
+void SpatialIndex::build(const std::vector<QVector3D>& points)
+{
+    clear();
+    m_points = points;
+    if (m_points.empty()) return;
+
+    m_order.resize(m_points.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = static_cast<int>(i);
+    }
+    m_nodes.reserve(2 * m_points.size() / LEAF_SIZE + 1);
+    buildNode(0, static_cast<int>(m_order.size()));
+}
+
+int SpatialIndex::buildNode(int begin, int end)
+{
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.min = node.max = m_points[m_order[begin]];
+    for (int i = begin + 1; i < end; ++i) {
+        const QVector3D& p = m_points[m_order[i]];
+        for (int axis = 0; axis < 3; ++axis) {
+            node.min[axis] = std::min(node.min[axis], p[axis]);
+            node.max[axis] = std::max(node.max[axis], p[axis]);
+        }
+    }
+
+    int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node);
+
+    if (end - begin <= LEAF_SIZE) {
+        return nodeIndex;
+    }
+
+    // Split on the widest axis at the median
+    QVector3D extent = node.max - node.min;
+    int axis = 0;
+    if (extent.y() > extent[axis]) axis = 1;
+    if (extent.z() > extent[axis]) axis = 2;
+
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+        [this, axis](int a, int b) { return m_points[a][axis] < m_points[b][axis]; });
+
+    int left = buildNode(begin, mid);
+    int right = buildNode(mid, end);
+    m_nodes[nodeIndex].left = left;
+    m_nodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+std::vector<int> SpatialIndex::nearest(const QVector3D& origin, size_t k) const
+{
+    std::vector<int> result;
+    if (m_nodes.empty() || k == 0) return result;
+
+    // Max-heap of the best candidates so far, worst on top
+    using Candidate = std::pair<float, int>;
+    std::priority_queue<Candidate> best;
+
+    // Min-heap of nodes to visit, ordered by distance to their bounds
+    using PendingNode = std::pair<float, int>;
+    std::priority_queue<PendingNode, std::vector<PendingNode>, std::greater<PendingNode>> pending;
+    pending.emplace(distanceSquaredToBox(origin, m_nodes[0].min, m_nodes[0].max), 0);
+
+    while (!pending.empty()) {
+        auto [boxDist, nodeIndex] = pending.top();
+        pending.pop();
+        if (best.size() == k && boxDist > best.top().first) break;
+
+        const Node& node = m_nodes[nodeIndex];
+        if (node.left == -1) {
+            for (int i = node.begin; i < node.end; ++i) {
+                int idx = m_order[i];
+                float dist = (m_points[idx] - origin).lengthSquared();
+                if (best.size() < k) {
+                    best.emplace(dist, idx);
+                }
+                else if (dist < best.top().first) {
+                    best.pop();
+                    best.emplace(dist, idx);
+                }
+            }
+            continue;
+        }
+
+        for (int child : { node.left, node.right }) {
+            float childDist = distanceSquaredToBox(origin, m_nodes[child].min, m_nodes[child].max);
+            if (best.size() < k || childDist <= best.top().first) {
+                pending.emplace(childDist, child);
+            }
+        }
+    }
+
+    result.resize(best.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = best.top().second;
+        best.pop();
+    }
+    return result;
+}
+
+std::vector<int> SpatialIndex::withinRadius(const QVector3D& origin, float radius) const
+{
+    std::vector<std::pair<float, int>> hits;
+    if (m_nodes.empty() || radius < 0.0f) return {};
+
+    const float radiusSq = radius * radius;
+    std::vector<int> stack = { 0 };
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (distanceSquaredToBox(origin, node.min, node.max) > radiusSq) continue;
+
+        if (node.left == -1) {
+            for (int i = node.begin; i < node.end; ++i) {
+                int idx = m_order[i];
+                float dist = (m_points[idx] - origin).lengthSquared();
+                if (dist <= radiusSq) hits.emplace_back(dist, idx);
+            }
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end());
+    std::vector<int> result;
+    result.reserve(hits.size());
+    for (const auto& hit : hits) result.push_back(hit.second);
+    return result;
+}
+
+std::vector<int> SpatialIndex::alongRay(const QVector3D& origin, const QVector3D& direction, float maxDistance, float radius) const
+{
+    std::vector<std::pair<float, int>> hits;
+    if (m_nodes.empty() || direction.isNull() || radius < 0.0f) return {};
+
+    const QVector3D dir = direction.normalized();
+    std::vector<int> stack = { 0 };
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        // Conservative reject using the bounding sphere of the node's box
+        QVector3D center = (node.min + node.max) * 0.5f;
+        float boundRadius = (node.max - center).length();
+        if (distanceToSegment(center, origin, dir, maxDistance, nullptr) > radius + boundRadius) continue;
+
+        if (node.left == -1) {
+            for (int i = node.begin; i < node.end; ++i) {
+                int idx = m_order[i];
+                float along = 0.0f;
+                if (distanceToSegment(m_points[idx], origin, dir, maxDistance, &along) <= radius) {
+                    hits.emplace_back(along, idx);
+                }
+            }
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end());
+    std::vector<int> result;
+    result.reserve(hits.size());
+    for (const auto& hit : hits) result.push_back(hit.second);
+    return result;
+}
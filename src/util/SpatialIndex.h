@@ -0,0 +1,41 @@
+#pragma once
+#include <QVector3D>
+#include <vector>
+
+// Static k-d tree over a snapshot of 3D points. Built once per snapshot and
+// queried by index into the point list it was built from.
+class SpatialIndex
+{
+public:
+    void build(const std::vector<QVector3D>& points);
+    void clear();
+
+    bool isEmpty() const { return m_points.empty(); }
+    size_t size() const { return m_points.size(); }
+
+    // Indices of the k closest points, nearest first
+    std::vector<int> nearest(const QVector3D& origin, size_t k) const;
+
+    // Indices of all points within radius of origin, nearest first
+    std::vector<int> withinRadius(const QVector3D& origin, float radius) const;
+
+    // Indices of all points within radius of the segment origin -> origin + direction * maxDistance,
+    // ordered by distance along the ray
+    std::vector<int> alongRay(const QVector3D& origin, const QVector3D& direction, float maxDistance, float radius) const;
+
+private:
+    struct Node {
+        QVector3D min;
+        QVector3D max;
+        int begin;
+        int end;
+        int left = -1;
+        int right = -1;
+    };
+
+    int buildNode(int begin, int end);
+
+    std::vector<QVector3D> m_points;
+    std::vector<int> m_order;
+    std::vector<Node> m_nodes;
+};
@@ -0,0 +1,58 @@
+#include "SuffixIndex.h"
+#include <algorithm>
+
+void SuffixIndex::clear()
+{
+    m_text.clear();
+    m_documentStarts.clear();
+    m_suffixes.clear();
+}
+
+void SuffixIndex::build(const QStringList& documents)
+{
+    clear();
+
+    qsizetype totalLength = 0;
+    for (const QString& document : documents) totalLength += document.size();
+    m_text.reserve(totalLength);
+    m_documentStarts.reserve(documents.size() + 1);
+    m_suffixes.reserve(totalLength);
+
+    for (int i = 0; i < documents.size(); ++i) {
+        const int start = int(m_text.size());
+        m_documentStarts.push_back(start);
+        m_text += documents[i].toCaseFolded();
+        for (int position = start; position < int(m_text.size()); ++position) {
+            m_suffixes.push_back(Suffix{ position, i });
+        }
+    }
+    m_documentStarts.push_back(int(m_text.size()));
+
+    std::sort(m_suffixes.begin(), m_suffixes.end(), [this](const Suffix& a, const Suffix& b) {
+        const int order = suffixView(a).compare(suffixView(b));
+        return order != 0 ? order < 0 : a.position < b.position;
+    });
+}
+
+std::vector<int> SuffixIndex::search(const QString& query) const
+{
+    std::vector<int> result;
+    const QString folded = query.toCaseFolded();
+    if (folded.isEmpty() || m_suffixes.empty()) return result;
+
+    // Suffixes starting with the query sort together, right after everything smaller than it
+    const auto first = std::partition_point(m_suffixes.begin(), m_suffixes.end(), [this, &folded](const Suffix& suffix) {
+        return suffixView(suffix).compare(folded) < 0;
+    });
+    const auto last = std::partition_point(first, m_suffixes.end(), [this, &folded](const Suffix& suffix) {
+        return suffixView(suffix).startsWith(folded);
+    });
+
+    result.reserve(last - first);
+    for (auto it = first; it != last; ++it) {
+        result.push_back(it->document);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
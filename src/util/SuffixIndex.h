@@ -0,0 +1,36 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <vector>
+
+// Suffix array for case-insensitive substring search over a fixed set of
+// documents. Every suffix is cut off at the end of its document, so a match
+// never spans two of them. Unlike a trigram index, queries of any length are
+// answered by binary search.
+class SuffixIndex
+{
+public:
+    void build(const QStringList& documents);
+    void clear();
+
+    bool isEmpty() const { return m_documentStarts.empty(); }
+    size_t size() const { return m_documentStarts.empty() ? 0 : m_documentStarts.size() - 1; }
+
+    // Indices of documents containing query, ascending. An empty query matches nothing
+    std::vector<int> search(const QString& query) const;
+
+private:
+    struct Suffix {
+        int position;
+        int document;
+    };
+
+    QStringView suffixView(const Suffix& suffix) const {
+        return QStringView(m_text).mid(suffix.position, m_documentStarts[suffix.document + 1] - suffix.position);
+    }
+
+    QString m_text; // Case folded documents back to back
+    std::vector<int> m_documentStarts; // One past the last document's end as well
+    std::vector<Suffix> m_suffixes; // Sorted
+};
@@ -0,0 +1,322 @@
+#include "WeaponStatTable.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LTCON_WEAPON_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using replicant::raw::RawWeaponBody;
+using replicant::raw::RawWeaponEntry;
+using replicant::weapon::WeaponStats;
+using replicant::weapon::WeaponUpgradeRecipe;
+
+namespace {
+    constexpr int INT_COLUMNS = 12;
+    constexpr int FLOAT_COLUMNS = 3;
+    constexpr size_t NO_FIELD = std::numeric_limits<size_t>::max();
+
+    // Largest float below 2^31, scaled integers are kept within it before converting back
+    constexpr float INT_LIMIT = 2147483520.0f;
+
+    struct ColumnInfo {
+        size_t offset; // Within WeaponStats or WeaponUpgradeRecipe
+        bool isFloat;
+        bool recipe;
+        int slot; // Column index among the int or the float ones
+    };
+
+    constexpr ColumnInfo COLUMNS[] = {
+        { offsetof(WeaponStats, attack), false, false, 0 },
+        { offsetof(WeaponStats, magicPower), false, false, 1 },
+        { offsetof(WeaponStats, guardBreak), false, false, 2 },
+        { offsetof(WeaponStats, armourBreak), false, false, 3 },
+        { offsetof(WeaponStats, float_0x10), true, false, 0 },
+        { offsetof(WeaponStats, weight), false, false, 4 },
+        { offsetof(WeaponStats, float_0x18), true, false, 1 },
+        { offsetof(WeaponStats, float_0x1c), true, false, 2 },
+        { offsetof(WeaponUpgradeRecipe, upgradeCost), false, true, 5 },
+        { offsetof(WeaponUpgradeRecipe, ingredientId1), false, true, 6 },
+        { offsetof(WeaponUpgradeRecipe, ingredientCount1), false, true, 7 },
+        { offsetof(WeaponUpgradeRecipe, ingredientId2), false, true, 8 },
+        { offsetof(WeaponUpgradeRecipe, ingredientCount2), false, true, 9 },
+        { offsetof(WeaponUpgradeRecipe, ingredientId3), false, true, 10 },
+        { offsetof(WeaponUpgradeRecipe, ingredientCount3), false, true, 11 },
+    };
+    static_assert(std::size(COLUMNS) == static_cast<size_t>(WeaponColumn::Count));
+
+    constexpr size_t STATS_OFFSETS[WeaponStatTable::LEVELS] = {
+        offsetof(RawWeaponBody, level1Stats), offsetof(RawWeaponBody, level2Stats),
+        offsetof(RawWeaponBody, level3Stats), offsetof(RawWeaponBody, level4Stats)
+    };
+    constexpr size_t RECIPE_OFFSETS[WeaponStatTable::LEVELS] = {
+        NO_FIELD, offsetof(RawWeaponBody, level2Recipe),
+        offsetof(RawWeaponBody, level3Recipe), offsetof(RawWeaponBody, level4Recipe)
+    };
+
+    const ColumnInfo& info(WeaponColumn column) {
+        return COLUMNS[static_cast<size_t>(column)];
+    }
+
+    // Byte offset of the column's field at that level within a body, NO_FIELD if it has none
+    size_t fieldOffset(const ColumnInfo& column, int level) {
+        const size_t base = column.recipe ? RECIPE_OFFSETS[level] : STATS_OFFSETS[level];
+        return base == NO_FIELD ? NO_FIELD : base + column.offset;
+    }
+
+    std::byte* bodyBytes(RawWeaponBody* body) { return reinterpret_cast<std::byte*>(body); }
+    const std::byte* bodyBytes(const RawWeaponEntry& entry) { return reinterpret_cast<const std::byte*>(&entry.body); }
+    std::byte* bodyBytes(RawWeaponEntry& entry) { return reinterpret_cast<std::byte*>(&entry.body); }
+
+    void scaleInts(const int32_t* source, int32_t* target, size_t count, float factor) {
+        size_t i = 0;
+#ifdef LTCON_WEAPON_TABLE_SSE2
+        const __m128 f = _mm_set1_ps(factor);
+        const __m128 low = _mm_set1_ps(-INT_LIMIT);
+        const __m128 high = _mm_set1_ps(INT_LIMIT);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+            v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(v, f), low), high);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_cvtps_epi32(v));
+        }
+#endif
+        for (; i < count; ++i) {
+            const float v = std::clamp(float(source[i]) * factor, -INT_LIMIT, INT_LIMIT);
+            target[i] = static_cast<int32_t>(std::nearbyint(v));
+        }
+    }
+
+    void scaleFloats(const float* source, float* target, size_t count, float factor) {
+        size_t i = 0;
+#ifdef LTCON_WEAPON_TABLE_SSE2
+        const __m128 f = _mm_set1_ps(factor);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(target + i, _mm_mul_ps(_mm_loadu_ps(source + i), f));
+        }
+#endif
+        for (; i < count; ++i) {
+            target[i] = source[i] * factor;
+        }
+    }
+
+    void clampInts(int32_t* values, size_t count, int32_t minimum, int32_t maximum) {
+        size_t i = 0;
+#ifdef LTCON_WEAPON_TABLE_SSE2
+        // SSE2 has no 32-bit min and max, select through compare masks instead
+        const __m128i low = _mm_set1_epi32(minimum);
+        const __m128i high = _mm_set1_epi32(maximum);
+        for (; i + 4 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i above = _mm_cmpgt_epi32(v, high);
+            v = _mm_or_si128(_mm_and_si128(above, high), _mm_andnot_si128(above, v));
+            __m128i below = _mm_cmplt_epi32(v, low);
+            v = _mm_or_si128(_mm_and_si128(below, low), _mm_andnot_si128(below, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), v);
+        }
+#endif
+        for (; i < count; ++i) {
+            values[i] = std::clamp(values[i], minimum, maximum);
+        }
+    }
+
+    void clampFloats(float* values, size_t count, float minimum, float maximum) {
+        size_t i = 0;
+#ifdef LTCON_WEAPON_TABLE_SSE2
+        const __m128 low = _mm_set1_ps(minimum);
+        const __m128 high = _mm_set1_ps(maximum);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(values + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + i), low), high));
+        }
+#endif
+        for (; i < count; ++i) {
+            values[i] = std::clamp(values[i], minimum, maximum);
+        }
+    }
+
+    int32_t toIntBound(float value) {
+        return static_cast<int32_t>(std::nearbyint(std::clamp(value, -INT_LIMIT, INT_LIMIT)));
+    }
+}
+
+bool WeaponStatTable::isFloat(WeaponColumn column)
+{
+    return info(column).isFloat;
+}
+
+bool WeaponStatTable::hasLevel(WeaponColumn column, int level)
+{
+    return level >= 0 && level < LEVELS && fieldOffset(info(column), level) != NO_FIELD;
+}
+
+void WeaponStatTable::resize(int weapons)
+{
+    m_weapons = weapons;
+    m_stride = (weapons + 3) & ~3;
+    m_ints.assign(size_t(INT_COLUMNS) * LEVELS * m_stride, 0);
+    m_floats.assign(size_t(FLOAT_COLUMNS) * LEVELS * m_stride, 0.0f);
+}
+
+int32_t* WeaponStatTable::intColumn(WeaponColumn column, int level)
+{
+    return m_ints.data() + (size_t(info(column).slot) * LEVELS + level) * m_stride;
+}
+
+const int32_t* WeaponStatTable::intColumn(WeaponColumn column, int level) const
+{
+    return m_ints.data() + (size_t(info(column).slot) * LEVELS + level) * m_stride;
+}
+
+float* WeaponStatTable::floatColumn(WeaponColumn column, int level)
+{
+    return m_floats.data() + (size_t(info(column).slot) * LEVELS + level) * m_stride;
+}
+
+const float* WeaponStatTable::floatColumn(WeaponColumn column, int level) const
+{
+    return m_floats.data() + (size_t(info(column).slot) * LEVELS + level) * m_stride;
+}
+
+std::span<int32_t> WeaponStatTable::ints(WeaponColumn column, int level)
+{
+    if (info(column).isFloat || level < 0 || level >= LEVELS) return {};
+    return std::span<int32_t>(intColumn(column, level), m_weapons);
+}
+
+std::span<float> WeaponStatTable::floats(WeaponColumn column, int level)
+{
+    if (!info(column).isFloat || level < 0 || level >= LEVELS) return {};
+    return std::span<float>(floatColumn(column, level), m_weapons);
+}
+
+template <typename Row>
+void WeaponStatTable::gatherRows(std::span<Row> rows)
+{
+    resize(int(rows.size()));
+
+    for (size_t c = 0; c < std::size(COLUMNS); ++c) {
+        const WeaponColumn column = static_cast<WeaponColumn>(c);
+        for (int level = 0; level < LEVELS; ++level) {
+            const size_t offset = fieldOffset(COLUMNS[c], level);
+            if (offset == NO_FIELD) continue;
+
+            // Both kinds are 4 bytes, copied as they are
+            void* target = COLUMNS[c].isFloat ? static_cast<void*>(floatColumn(column, level)) : static_cast<void*>(intColumn(column, level));
+            for (size_t w = 0; w < rows.size(); ++w) {
+                const std::byte* body = bodyBytes(rows[w]);
+                if (!body) continue;
+                std::memcpy(static_cast<std::byte*>(target) + w * 4, body + offset, 4);
+            }
+        }
+    }
+}
+
+template <typename Row>
+void WeaponStatTable::scatterRows(std::span<Row> rows) const
+{
+    const size_t count = std::min(rows.size(), size_t(m_weapons));
+
+    for (size_t c = 0; c < std::size(COLUMNS); ++c) {
+        const WeaponColumn column = static_cast<WeaponColumn>(c);
+        for (int level = 0; level < LEVELS; ++level) {
+            const size_t offset = fieldOffset(COLUMNS[c], level);
+            if (offset == NO_FIELD) continue;
+
+            const void* source = COLUMNS[c].isFloat ? static_cast<const void*>(floatColumn(column, level)) : static_cast<const void*>(intColumn(column, level));
+            for (size_t w = 0; w < count; ++w) {
+                std::byte* body = bodyBytes(rows[w]);
+                if (!body) continue;
+                std::memcpy(body + offset, static_cast<const std::byte*>(source) + w * 4, 4);
+            }
+        }
+    }
+}
+
+void WeaponStatTable::gather(std::span<RawWeaponBody* const> bodies)
+{
+    gatherRows(bodies);
+}
+
+void WeaponStatTable::gather(std::span<const RawWeaponEntry> entries)
+{
+    gatherRows(entries);
+}
+
+void WeaponStatTable::scatter(std::span<RawWeaponBody* const> bodies) const
+{
+    scatterRows(bodies);
+}
+
+void WeaponStatTable::scatter(std::span<RawWeaponEntry> entries) const
+{
+    scatterRows(entries);
+}
+
+void WeaponStatTable::scale(WeaponColumn column, float factor, int firstLevel, int lastLevel)
+{
+    firstLevel = std::max(firstLevel, 0);
+    lastLevel = std::min(lastLevel, LEVELS - 1);
+    if (firstLevel > lastLevel) return;
+
+    // Levels of a column are adjacent, the whole range is one run
+    const size_t count = size_t(lastLevel - firstLevel + 1) * m_stride;
+    if (info(column).isFloat) {
+        float* values = floatColumn(column, firstLevel);
+        scaleFloats(values, values, count, factor);
+    }
+    else {
+        int32_t* values = intColumn(column, firstLevel);
+        scaleInts(values, values, count, factor);
+    }
+}
+
+void WeaponStatTable::clamp(WeaponColumn column, float minimum, float maximum, int firstLevel, int lastLevel)
+{
+    firstLevel = std::max(firstLevel, 0);
+    lastLevel = std::min(lastLevel, LEVELS - 1);
+    if (firstLevel > lastLevel || minimum > maximum) return;
+
+    const size_t count = size_t(lastLevel - firstLevel + 1) * m_stride;
+    if (info(column).isFloat) {
+        clampFloats(floatColumn(column, firstLevel), count, minimum, maximum);
+    }
+    else {
+        clampInts(intColumn(column, firstLevel), count, toIntBound(minimum), toIntBound(maximum));
+    }
+}
+
+void WeaponStatTable::applyCurve(WeaponColumn column, int baseLevel, const std::array<float, LEVELS>& factors)
+{
+    // Recipes have no level 1 row, its zeros would wipe every real level
+    if (!hasLevel(column, baseLevel)) return;
+
+    auto scaleLevel = [&](int level) {
+        if (info(column).isFloat) {
+            scaleFloats(floatColumn(column, baseLevel), floatColumn(column, level), m_stride, factors[level]);
+        }
+        else {
+            scaleInts(intColumn(column, baseLevel), intColumn(column, level), m_stride, factors[level]);
+        }
+    };
+
+    // The base level is read by all the others, so it is rescaled last
+    for (int level = 0; level < LEVELS; ++level) {
+        if (level != baseLevel && hasLevel(column, level)) scaleLevel(level);
+    }
+    scaleLevel(baseLevel);
+}
+
+void WeaponStatTable::copyFromLevel(WeaponColumn column, int fromLevel, int toLevel)
+{
+    if (!hasLevel(column, fromLevel) || !hasLevel(column, toLevel) || fromLevel == toLevel) return;
+
+    if (info(column).isFloat) {
+        std::memcpy(floatColumn(column, toLevel), floatColumn(column, fromLevel), sizeof(float) * m_stride);
+    }
+    else {
+        std::memcpy(intColumn(column, toLevel), intColumn(column, fromLevel), sizeof(int32_t) * m_stride);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <replicant/weapon.h>
+#include <array>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+// Per level fields of a weapon body. Stats exist for levels 1 to 4, upgrade
+// recipes only for 2 to 4, their level 1 rows stay zero and are never written back
+enum class WeaponColumn {
+    Attack,
+    MagicPower,
+    GuardBreak,
+    ArmourBreak,
+    Float10,
+    Weight,
+    Float18,
+    Float1C,
+    UpgradeCost,
+    IngredientId1,
+    IngredientCount1,
+    IngredientId2,
+    IngredientCount2,
+    IngredientId3,
+    IngredientCount3,
+    Count
+};
+
+// Structure of arrays copy of the level stats and upgrade recipes of a set of
+// weapon bodies, for balance passes over all of them at once. Each column holds
+// every level of every weapon contiguously, level by level, so a transform of a
+// field across all weapons and levels is one vectorized loop.
+//
+// Integer fields are handled as signed 32-bit values, which every value the game
+// uses fits. Rows follow the span gathered from; null bodies are skipped on both
+// gather and scatter. Scattering into the live table has to happen on the game thread.
+class WeaponStatTable
+{
+public:
+    static constexpr int LEVELS = 4;
+
+    void gather(std::span<replicant::raw::RawWeaponBody* const> bodies);
+    void gather(std::span<const replicant::raw::RawWeaponEntry> entries);
+    void scatter(std::span<replicant::raw::RawWeaponBody* const> bodies) const;
+    void scatter(std::span<replicant::raw::RawWeaponEntry> entries) const;
+
+    int weaponCount() const { return m_weapons; }
+
+    static bool isFloat(WeaponColumn column);
+    static bool hasLevel(WeaponColumn column, int level);
+
+    // One level of a column, a value per weapon. Use the one matching isFloat
+    std::span<int32_t> ints(WeaponColumn column, int level);
+    std::span<float> floats(WeaponColumn column, int level);
+
+    // Levels are 0 based, firstLevel to lastLevel inclusive. Integer results round to nearest
+    void scale(WeaponColumn column, float factor, int firstLevel = 0, int lastLevel = LEVELS - 1);
+    void clamp(WeaponColumn column, float minimum, float maximum, int firstLevel = 0, int lastLevel = LEVELS - 1);
+    // Every level recomputed as baseLevel's values times factors[level]. These two do
+    // nothing when a level they read or write has no field for the column, see hasLevel
+    void applyCurve(WeaponColumn column, int baseLevel, const std::array<float, LEVELS>& factors);
+    void copyFromLevel(WeaponColumn column, int fromLevel, int toLevel);
+
+private:
+    template <typename Row>
+    void gatherRows(std::span<Row> rows);
+    template <typename Row>
+    void scatterRows(std::span<Row> rows) const;
+
+    void resize(int weapons);
+    int32_t* intColumn(WeaponColumn column, int level);
+    const int32_t* intColumn(WeaponColumn column, int level) const;
+    float* floatColumn(WeaponColumn column, int level);
+    const float* floatColumn(WeaponColumn column, int level) const;
+
+    int m_weapons = 0;
+    int m_stride = 0; // Weapon count rounded up to whole vectors, the padding stays zero
+    std::vector<int32_t> m_ints;
+    std::vector<float> m_floats;
+};